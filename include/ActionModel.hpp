@@ -0,0 +1,47 @@
+#ifndef ACTION_MODEL_HPP
+#define ACTION_MODEL_HPP
+
+#include <utility>
+#include <vector>
+
+struct ActionOutcome {
+  int dx;
+  int dy;
+  float probability;
+  // Index of the P value (0 - p1, 1 - p2, 2 - p3) the probability was taken
+  // from, -1 when it was given explicitly. Lets sweeps swap P per scenario.
+  int parameter;
+};
+
+struct ActionDefinition {
+  char symbol;
+  std::vector<ActionOutcome> outcomes;
+};
+
+// Action set of a world with the outcome stencil of every action.
+class ActionModel {
+public:
+  // '<', '>', '^', 'v': intended move with p1, sideways slips with p2 / p3.
+  static ActionModel fourConnected(float p1, float p2, float p3);
+  // The four moves plus diagonals '7', '9', '1', '3' (numeric keypad
+  // layout); slips go to the neighbouring compass directions, p2
+  // counter-clockwise and p3 clockwise.
+  static ActionModel eightConnected(float p1, float p2, float p3);
+
+  // Replaces the action with the same symbol or appends a new one.
+  void setAction(const ActionDefinition &action);
+
+  const std::vector<ActionDefinition> &getActions() const { return actions; }
+  int getActionCount() const { return actions.size(); }
+  int getOutcomeCount() const; // largest stencil
+  int getReach() const;        // largest |dx| or |dy|
+  int getIndex(char symbol) const; // -1 for unknown symbols
+  // Intended move of a P stencil, otherwise the most likely outcome. Used
+  // when the dynamics are followed deterministically.
+  std::pair<int, int> getMove(int action) const;
+
+private:
+  std::vector<ActionDefinition> actions;
+};
+
+#endif // ACTION_MODEL_HPP
@@ -0,0 +1,75 @@
+#ifndef ASYNC_VALUE_ITERATION_HPP
+#define ASYNC_VALUE_ITERATION_HPP
+
+#include "Precision.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Asynchronous value iteration over square tiles of the grid. A tile is
+// swept until it converges locally and marks the neighbouring tiles dirty
+// when its boundary values moved by more than epsilon since it last did so.
+// A tile is never swept by two threads at once. Dirty tiles are
+// queued on per-thread deques; idle threads steal from the others, so
+// there is no barrier between sweeps and converged regions are left alone.
+// Utilities are stored as T (float, BFloat16 or Half), backups are computed
+// in float.
+template <class T> class AsyncValueIteration {
+public:
+  AsyncValueIteration(const TransitionModel &model, int tileSize = 32);
+
+  // Starting utility of a free cell, e.g. from an earlier solution of a
+  // similar world. Fixed cells keep their own.
+  void setValue(int cell, float value);
+
+  // Runs until no tile is dirty, returns the number of processed tiles.
+  long solve(float epsilon, unsigned threads);
+
+  float getValue(int cell) const { return values[cell]; }
+  char getPolicy(int cell) const;
+  long getSteals() const { return steals; }
+
+  void apply(World &world) const;
+
+private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<int> tiles;
+  };
+
+  void work(unsigned self, float epsilon);
+  bool popTile(unsigned self, int &tile);
+  // Tile states: waiting in a queue, being swept, and dirtied again while
+  // being swept.
+  enum : unsigned char { kQueued = 1, kRunning = 2, kRerun = 4 };
+
+  // Atomic utility that reads as float, for TransitionModel::backup.
+  struct Value {
+    std::atomic<T> value;
+    operator float() const { return value.load(std::memory_order_relaxed); }
+    void store(float v) { value.store(T(v), std::memory_order_relaxed); }
+  };
+
+  void markDirty(int tile, unsigned worker);
+  void enqueue(int tile, unsigned worker);
+  void processTile(int tile, unsigned worker, float epsilon);
+
+  const TransitionModel &model;
+  int tileSize;
+  int tilesX;
+  int tilesY;
+  std::unique_ptr<Value[]> values;
+  std::unique_ptr<std::atomic<unsigned char>[]> tileStates;
+  // Values of the border cells as last passed on to the neighbour tiles.
+  std::unique_ptr<float[]> notified;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::atomic<long> pending;
+  std::atomic<long> processed;
+  std::atomic<long> steals;
+};
+
+#endif // ASYNC_VALUE_ITERATION_HPP
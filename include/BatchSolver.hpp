@@ -0,0 +1,73 @@
+#ifndef BATCH_SOLVER_HPP
+#define BATCH_SOLVER_HPP
+
+#include "DataLoader.hpp"
+#include "Precision.hpp"
+#include "TransitionModel.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+// One parameter set of a sweep: G, R and P of the world file.
+struct SweepScenario {
+  float gamma;
+  float reward;
+  float p1, p2, p3;
+  // False when neither the world nor the sweep line gives P (M 0 worlds).
+  bool hasProbabilities;
+};
+
+// Reads a sweep file with one scenario per line, e.g. "G 0.9 R -0.04".
+// Labels follow the world file; missing ones are taken from `defaults`.
+std::vector<SweepScenario> loadSweepScenarios(const std::string &filename,
+                                              const DataLoader &defaults);
+
+// Value iteration of many scenarios over one TransitionModel. Values of all
+// scenarios are stored side by side per cell, so a single sweep over the
+// grid updates every scenario with the same neighbour loads.
+// Utilities and rewards are stored as T (float, double, BFloat16 or Half) and
+// accumulated in ValueTraits<T>::Accumulator.
+template <class T> class BatchSolver {
+public:
+  typedef typename ValueTraits<T>::Accumulator Accumulator;
+  static const int kLanes = 8;
+
+  BatchSolver(const TransitionModel &model,
+              const std::vector<SweepScenario> &scenarios);
+
+  // Sweeps until every scenario changes by less than epsilon, returns the
+  // number of sweeps done.
+  int solve(Accumulator epsilon, int maxIterations);
+
+  int getScenarioCount() const { return scenarioCount; }
+  const SweepScenario &getScenario(int scenario) const {
+    return scenarios[scenario];
+  }
+  // Sweeps after which the scenario converged, -1 if it did not.
+  int getIterations(int scenario) const { return iterations[scenario]; }
+  Accumulator getValue(int scenario, int cell) const {
+    return static_cast<Accumulator>(values[cell * stride + scenario]);
+  }
+  char getPolicy(int scenario, int cell) const;
+
+  void writeTable(int scenario, std::ostream &out) const;
+  // Writes one "<prefix><scenario>.txt" table per scenario.
+  void writeTables(const std::string &prefix) const;
+
+private:
+  // One sweep over the grid. A and O fix the action and outcome counts of
+  // the built-in stencils at compile time, 0 reads them from the model.
+  template <int A, int O> void sweepCells(std::vector<Accumulator> &deltas);
+
+  const TransitionModel &model;
+  std::vector<SweepScenario> scenarios;
+  int scenarioCount;
+  int stride; // scenarios padded to a multiple of kLanes
+  std::vector<T> values;
+  std::vector<T> rewards;
+  std::vector<Accumulator> weights; // [action][outcome][lane]
+  std::vector<Accumulator> gammas;
+  std::vector<int> iterations;
+};
+
+#endif // BATCH_SOLVER_HPP
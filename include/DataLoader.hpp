@@ -1,6 +1,7 @@
 #ifndef DATALOADER_HPP
 #define DATALOADER_HPP
 
+#include "ActionModel.hpp"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -29,12 +30,15 @@ struct ForbiddenState {
 class DataLoader {
 public:
   void load(const std::string &filename);
+  void load(std::istream &input);
 
   void printData() const;
 
   // Getters
   std::pair<int, int> getWorldSize() const;
   std::pair<int, int> getStartState() const;
+  // False for M 0 worlds that give every probability on their A lines.
+  bool hasProbabilities() const;
   std::tuple<float, float, float> getProbabilities() const;
   float getDefaultReward() const;
   float getGamma() const;
@@ -42,6 +46,11 @@ public:
   const std::vector<TerminalState> &getTerminalStates() const;
   const std::vector<SpecialState> &getSpecialStates() const;
   const std::vector<ForbiddenState> &getForbiddenStates() const;
+  // Built-in stencil chosen by M (4 by default) with the A actions applied.
+  ActionModel getActionModel() const;
+
+  static const int kMaxWorldSide = 1 << 16;
+  static const long long kMaxWorldCells = 1 << 26;
 
 private:
   void parseLine(const std::string &line);
@@ -55,7 +64,7 @@ private:
   int startY = -1;
   bool startStateSet = false;
 
-  float p1, p2, p3;
+  float p1{}, p2{}, p3{};
   bool probabilitiesSet = false;
 
   float defaultReward;
@@ -70,6 +79,9 @@ private:
   std::vector<TerminalState> terminalStates;
   std::vector<SpecialState> specialStates;
   std::vector<ForbiddenState> forbiddenStates;
+
+  int moveModel = 4;
+  std::vector<ActionDefinition> customActions;
 };
 
 #endif // DATALOADER_HPP
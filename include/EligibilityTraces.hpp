@@ -0,0 +1,33 @@
+#ifndef ELIGIBILITY_TRACES_HPP
+#define ELIGIBILITY_TRACES_HPP
+
+#include <cstddef>
+#include <vector>
+
+struct Trace {
+  int x;
+  int y;
+  char action;
+  float eligibility;
+};
+
+// Replacing eligibility traces kept as a short list of the recently visited
+// state-actions. Traces that decay below the threshold are dropped, so the
+// list stays bounded no matter how large the world is.
+class EligibilityTraces {
+public:
+  explicit EligibilityTraces(float threshold = 0.01f);
+
+  void visit(int x, int y, char action); // sets the trace back to 1
+  void decay(float factor);
+  void clear() { traces.clear(); }
+
+  const std::vector<Trace> &getTraces() const { return traces; }
+  size_t size() const { return traces.size(); }
+
+private:
+  std::vector<Trace> traces;
+  float threshold;
+};
+
+#endif // ELIGIBILITY_TRACES_HPP
@@ -0,0 +1,51 @@
+#ifndef EXPLORATION_HPP
+#define EXPLORATION_HPP
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+enum class ExplorationKind {
+  EpsilonGreedy,   // random action with probability epsilon
+  DecayingEpsilon, // epsilon * decay^episode, at least minEpsilon
+  UCB1,            // Q + c * sqrt(ln N(s) / N(s, a)), untried actions first
+  CountBonus,      // Q + bonus / sqrt(N(s, a) + 1)
+};
+
+ExplorationKind parseExplorationKind(const std::string &name);
+
+// Action selection of the Q-learning agents. Works on the Q-values and visit
+// counts of one state given as plain arrays, so choosing an action does not
+// allocate.
+class Exploration {
+public:
+  explicit Exploration(ExplorationKind kind = ExplorationKind::EpsilonGreedy,
+                       float epsilon = 0.1f);
+
+  void setDecay(float decay, float minEpsilon);
+  void setUCBConstant(float c) { ucbConstant = c; }
+  void setBonus(float bonus) { this->bonus = bonus; }
+
+  ExplorationKind getKind() const { return kind; }
+  float getEpsilon() const; // of the current episode
+  void nextEpisode() { ++episode; }
+
+  // Index of the action to take. `greedy` is the exploiting choice of the
+  // epsilon strategies, -1 if the state has none yet.
+  int select(const float *q, const uint32_t *visits, int count, int greedy,
+             std::mt19937_64 &rng) const;
+
+private:
+  int selectOptimistic(const float *q, const uint32_t *visits, int count,
+                       std::mt19937_64 &rng) const;
+
+  ExplorationKind kind;
+  float epsilon;
+  float decay;
+  float minEpsilon;
+  float ucbConstant;
+  float bonus;
+  long episode;
+};
+
+#endif // EXPLORATION_HPP
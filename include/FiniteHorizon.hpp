@@ -0,0 +1,55 @@
+#ifndef FINITE_HORIZON_HPP
+#define FINITE_HORIZON_HPP
+
+#include "Precision.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+// Backward induction over a finite horizon. Only the layers with k - 1 and k
+// steps to go are kept in memory; the policy of every stage is packed to a
+// few bits per cell and streamed out as soon as it is computed.
+//
+// Policy stream layout (host byte order):
+//   "FHP1", int32 width, height, actionCount, bitsPerAction, horizon, stages
+//   then per stage: int32 stepsToGo and the packed action indices, cell 0 in
+//   the lowest bits. Terminal and forbidden cells are stored as action 0.
+// The two layers are stored as T (float, BFloat16 or Half), backups are
+// computed in float.
+template <class T> class FiniteHorizon {
+public:
+  FiniteHorizon(const TransitionModel &model, int horizon);
+
+  // Runs all stages. When `policyOut` is set, the policies of the last
+  // `keepStages` computed stages (the first ones to be executed) are
+  // written to it; a negative count keeps all of them.
+  void solve(std::ostream *policyOut = nullptr, int keepStages = -1);
+
+  int getHorizon() const { return horizon; }
+  // Utility and action with the full horizon to go.
+  float getValue(int cell) const { return current[cell]; }
+  char getPolicy(int cell) const;
+
+  void apply(World &world) const;
+
+  static int bitsPerAction(int actionCount);
+  // Reads the action symbols of the stage with `stepsToGo` steps to go from
+  // a stream written by solve, ' ' for terminal and forbidden cells.
+  static std::vector<char> readStage(std::istream &in,
+                                     const TransitionModel &model,
+                                     int stepsToGo);
+
+private:
+  const TransitionModel &model;
+  int horizon;
+  int bits;
+  std::vector<T> previous;
+  std::vector<T> current;
+  std::vector<char> actions;
+  std::vector<uint8_t> packed;
+};
+
+#endif // FINITE_HORIZON_HPP
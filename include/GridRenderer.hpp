@@ -0,0 +1,44 @@
+#ifndef GRID_RENDERER_HPP
+#define GRID_RENDERER_HPP
+
+#include <ostream>
+#include <string>
+
+class World;
+
+// Draws the World grid in the printWorld layout into one reusable buffer
+// and writes it to a file descriptor with a single write call. Rendering can
+// be cropped to a viewport and throttled to every Nth episode.
+class GridRenderer {
+public:
+  explicit GridRenderer(const World &world);
+
+  // Inclusive 1-based cell range, clamped to the world.
+  void setViewport(int minX, int minY, int maxX, int maxY);
+  void setInterval(int every) { interval = every > 0 ? every : 1; }
+  bool shouldRender(int episode) const { return episode % interval == 0; }
+  int getMinX() const { return minX; }
+  int getMinY() const { return minY; }
+  int getMaxX() const { return maxX; }
+  int getMaxY() const { return maxY; }
+
+  const std::string &render();
+  void print(int fd = 1);
+
+  // Binary snapshot of the viewport: "MDPS", int32 minX, minY, maxX, maxY,
+  // then per cell, bottom row first, float utility, char type, char policy.
+  void writeSnapshot(std::ostream &out) const;
+  void saveSnapshot(const std::string &filename) const;
+
+  // Appends `value` like std::setw(width) << std::fixed
+  // << std::setprecision(4).
+  static void appendFixed(std::string &out, float value, int width);
+
+private:
+  const World &world;
+  int minX, minY, maxX, maxY;
+  int interval;
+  std::string buffer;
+};
+
+#endif // GRID_RENDERER_HPP
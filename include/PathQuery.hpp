@@ -0,0 +1,47 @@
+#ifndef PATH_QUERY_HPP
+#define PATH_QUERY_HPP
+
+#include "TransitionModel.hpp"
+#include <vector>
+
+enum class PathEnd {
+  Terminal, // reached a terminal cell
+  Cycle,    // the next step would revisit a cell of the path
+  NoAction, // stopped at a cell without policy
+};
+
+struct Path {
+  PathEnd end;
+  std::vector<int> cells; // start cell first
+};
+
+// Greedy trajectories of a fixed policy: every step follows the most likely
+// outcome of the cell's action. The next cell and the number of steps to the
+// end of the path are memoised per cell, so paths that share a suffix walk it
+// only once and a batch costs about the total length of its paths.
+// Not thread safe, the memo is filled by the queries.
+class PathQuery {
+public:
+  // `policy` holds an action symbol per cell, anything else means no action.
+  PathQuery(const TransitionModel &model, const std::vector<char> &policy);
+
+  Path query(int start);
+  std::vector<Path> query(const std::vector<int> &starts);
+
+  // Steps of the path from `start`, without building it.
+  int getLength(int start);
+  PathEnd getEnd(int start);
+
+  static const char *getEndName(PathEnd end);
+
+private:
+  void resolve(int start);
+
+  std::vector<int> next;   // -1 where the path ends
+  std::vector<int> length; // -1 until resolved
+  std::vector<PathEnd> ends;
+  std::vector<char> onWalk;
+  std::vector<int> walk;
+};
+
+#endif // PATH_QUERY_HPP
@@ -1,10 +1,12 @@
 #pragma once
+#include "ActionModel.hpp"
 #include <array>
 #include <map>
-using  PolicyMove = std::array<std::array<int, 2>, 3>;
+#include <vector>
+using  PolicyMove = std::vector<std::array<int, 2>>;
 using PolicyMoveWithReward = std::pair<PolicyMove, float>;
 using Policy = std::map<char, PolicyMoveWithReward>;
 
 
 
-Policy CreatePoliciesForPoint(int x, int y);
\ No newline at end of file
+Policy CreatePoliciesForPoint(int x, int y, const ActionModel &actions);
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef POLICY_EVALUATOR_HPP
+#define POLICY_EVALUATOR_HPP
+
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct EvaluationResult {
+  int cell;
+  long rollouts;
+  long truncated; // rollouts cut at the step limit or at a cell without policy
+  double mean;
+  double variance;
+  double halfWidth; // of the 95% confidence interval of the mean
+};
+
+// Monte Carlo evaluation of a fixed policy under the stochastic dynamics of a
+// TransitionModel. A rollout collects reward + gamma * reward + ... up to and
+// including the reward of the terminal cell it reaches.
+class PolicyEvaluator {
+public:
+  // Reads the policy field of `world`, which must match `model`.
+  PolicyEvaluator(const TransitionModel &model, const World &world);
+
+  // Runs `rollouts` rollouts from each start cell spread over `threads`
+  // threads, each with its own random stream derived from `seed`.
+  std::vector<EvaluationResult> evaluate(const std::vector<int> &starts,
+                                         long rollouts, int maxSteps,
+                                         unsigned threads,
+                                         uint64_t seed) const;
+
+private:
+  struct Accumulator {
+    double sum;
+    double squares;
+    long truncated;
+  };
+
+  void run(const std::vector<int> &starts, long rollouts, int maxSteps,
+           unsigned thread, unsigned threads, uint64_t seed,
+           std::vector<Accumulator> &totals) const;
+  double rollout(int start, int maxSteps, std::mt19937_64 &rng,
+                 bool &truncated) const;
+
+  const TransitionModel &model;
+  std::vector<int> actions; // -1 where the policy is empty
+};
+
+#endif // POLICY_EVALUATOR_HPP
@@ -0,0 +1,128 @@
+#ifndef PRECISION_HPP
+#define PRECISION_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+// 16-bit storage types. They only convert to and from float, all arithmetic
+// is done in the accumulator type of ValueTraits.
+
+// Upper half of an IEEE float: float range, 8 bit mantissa.
+struct BFloat16 {
+  uint16_t bits;
+
+  BFloat16() : bits(0) {}
+  BFloat16(float value) {
+    uint32_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    if ((word & 0x7fffffffu) > 0x7f800000u) {
+      bits = static_cast<uint16_t>((word >> 16) | 0x0040u); // keep NaN quiet
+      return;
+    }
+    // Round to nearest even.
+    word += 0x7fffu + ((word >> 16) & 1u);
+    bits = static_cast<uint16_t>(word >> 16);
+  }
+  operator float() const {
+    const uint32_t word = static_cast<uint32_t>(bits) << 16;
+    float value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+  }
+};
+
+// IEEE half precision: 5 bit exponent, 10 bit mantissa, max 65504.
+struct Half {
+  uint16_t bits;
+
+  Half() : bits(0) {}
+  Half(float value) {
+#ifdef __FLT16_MAX__
+    const _Float16 half = static_cast<_Float16>(value);
+    std::memcpy(&bits, &half, sizeof(bits));
+#else
+    uint32_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    const uint32_t sign = (word >> 16) & 0x8000u;
+    const uint32_t magnitude = word & 0x7fffffffu;
+    if (magnitude > 0x7f800000u) {
+      bits = static_cast<uint16_t>(sign | 0x7e00u);
+    } else if (magnitude >= 0x477ff000u) { // rounds above 65504
+      bits = static_cast<uint16_t>(sign | 0x7c00u);
+    } else if (magnitude < 0x38800000u) { // subnormal or zero
+      const int shift = 113 - static_cast<int>(magnitude >> 23);
+      if (shift > 11) {
+        bits = static_cast<uint16_t>(sign);
+        return;
+      }
+      const uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+      const uint32_t half = mantissa >> (shift + 13);
+      const uint32_t rest = mantissa & ((1u << (shift + 13)) - 1);
+      const uint32_t halfway = 1u << (shift + 12);
+      bits = static_cast<uint16_t>(
+          sign | (half + (rest > halfway || (rest == halfway && (half & 1)))));
+    } else {
+      const uint32_t rebased = magnitude - 0x38000000u;
+      bits = static_cast<uint16_t>(
+          sign | ((rebased + 0xfffu + ((rebased >> 13) & 1u)) >> 13));
+    }
+#endif
+  }
+  operator float() const {
+#ifdef __FLT16_MAX__
+    _Float16 half;
+    std::memcpy(&half, &bits, sizeof(half));
+    return static_cast<float>(half);
+#else
+    const uint32_t sign = static_cast<uint32_t>(bits & 0x8000u) << 16;
+    const uint32_t exponent = (bits >> 10) & 0x1fu;
+    uint32_t mantissa = bits & 0x3ffu;
+    uint32_t word;
+    if (exponent == 0x1fu) {
+      word = sign | 0x7f800000u | (mantissa << 13);
+    } else if (exponent != 0) {
+      word = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+      word = sign;
+    } else {
+      int shift = 0;
+      while (!(mantissa & 0x400u)) {
+        mantissa <<= 1;
+        ++shift;
+      }
+      word = sign | static_cast<uint32_t>(113 - shift) << 23 |
+             ((mantissa & 0x3ffu) << 13);
+    }
+    float value;
+    std::memcpy(&value, &word, sizeof(value));
+    return value;
+#endif
+  }
+};
+
+// Type the solver kernels accumulate in for a given storage type.
+template <class T> struct ValueTraits {
+  typedef float Accumulator;
+};
+template <> struct ValueTraits<double> {
+  typedef double Accumulator;
+};
+
+enum class Precision { Float, Double, BFloat16, Half };
+
+inline Precision parsePrecision(const std::string &name) {
+  if (name == "float" || name == "fp32") {
+    return Precision::Float;
+  } else if (name == "double" || name == "fp64") {
+    return Precision::Double;
+  } else if (name == "bf16") {
+    return Precision::BFloat16;
+  } else if (name == "fp16" || name == "half") {
+    return Precision::Half;
+  }
+  throw std::runtime_error("Unknown precision: " + name);
+}
+
+#endif // PRECISION_HPP
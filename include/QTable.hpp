@@ -0,0 +1,96 @@
+#ifndef Q_TABLE_HPP
+#define Q_TABLE_HPP
+
+#include "Precision.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct QTableStats {
+  size_t states;   // cells with an entry
+  size_t capacity; // slots
+  double occupancy;
+  double averageProbe; // extra slots looked at to find a stored cell
+  size_t maxProbe;
+  size_t bytes;
+};
+
+// Q-values and visit counts of the learning agents, indexed by cell
+// ((y - 1) * width + (x - 1)) and action index. Unseen entries read as 0.
+// Q-values are passed as float whatever the tables store.
+class QTable {
+public:
+  virtual ~QTable() {}
+
+  virtual float getQ(int cell, int action) const = 0;
+  virtual void setQ(int cell, int action, float value) = 0;
+  virtual uint32_t getVisits(int cell, int action) const = 0;
+  virtual void addVisit(int cell, int action) = 0;
+  virtual size_t getMemoryUsage() const = 0; // bytes
+  // Fills `stats` for hashed tables, false for tables without slots.
+  virtual bool getStats(QTableStats &) const { return false; }
+};
+
+// Flat arrays for every cell, allocated up front. Q-values are stored as T
+// (float, BFloat16 or Half).
+template <class T> class DenseQTable : public QTable {
+public:
+  DenseQTable(int cells, int actionCount);
+
+  float getQ(int cell, int action) const override {
+    return q[cell * actionCount + action];
+  }
+  void setQ(int cell, int action, float value) override {
+    q[cell * actionCount + action] = value;
+  }
+  uint32_t getVisits(int cell, int action) const override {
+    return visits[cell * actionCount + action];
+  }
+  void addVisit(int cell, int action) override {
+    ++visits[cell * actionCount + action];
+  }
+  size_t getMemoryUsage() const override;
+
+private:
+  int actionCount;
+  std::vector<T> q;
+  std::vector<uint32_t> visits;
+};
+
+// Open addressing table keyed by cell, with linear probing over a power of
+// two number of slots. A slot holds the key and the rows of all actions in
+// flat arrays, so entries need no allocation of their own. Only cells that
+// were written take a slot. The table doubles at half load while the old and
+// the doubled arrays together fit in `maxBytes`, so the cap also bounds the
+// peak of a rehash; past that it fills up to 3/4 load and then throws.
+// Q-values are stored as T like in DenseQTable.
+template <class T> class SparseQTable : public QTable {
+public:
+  SparseQTable(int actionCount, size_t maxBytes);
+
+  float getQ(int cell, int action) const override;
+  void setQ(int cell, int action, float value) override;
+  uint32_t getVisits(int cell, int action) const override;
+  void addVisit(int cell, int action) override;
+  size_t getMemoryUsage() const override;
+  bool getStats(QTableStats &stats) const override;
+
+private:
+  static const int32_t kEmpty = -1;
+
+  size_t bytesFor(size_t slots) const;
+  size_t home(int cell) const;
+  long find(int cell) const; // slot of `cell`, -1 if absent
+  size_t insert(int cell);   // slot of `cell`, added if absent
+  void rehash(size_t slots);
+
+  int actionCount;
+  size_t maxBytes;
+  size_t states;
+  int shift; // 64 - log2(slots), for Fibonacci hashing
+  std::vector<int32_t> keys;
+  std::vector<T> q;
+  std::vector<uint32_t> visits;
+};
+
+#endif // Q_TABLE_HPP
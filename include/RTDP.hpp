@@ -0,0 +1,51 @@
+#ifndef RTDP_HPP
+#define RTDP_HPP
+
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <random>
+#include <vector>
+
+// Real-time dynamic programming from a single start cell. Trials follow the
+// greedy policy through sampled outcomes and only back up the cells they
+// visit. In labelled mode (LRTDP) cells whose greedy graph has a residual
+// below epsilon are marked solved, and solving stops once the start is
+// solved. Values start from an optimistic bound, so cells the optimal policy
+// never reaches are never touched.
+class RTDP {
+public:
+  RTDP(const TransitionModel &model, float epsilon, unsigned seed = 0);
+
+  // Runs trials from `start` and returns their number. Labelled solving ends
+  // when the start is solved, plain RTDP when a whole trial changes no value
+  // by more than epsilon.
+  int solve(int start, int maxTrials, bool labelled = true);
+
+  float getValue(int cell) const { return values[cell]; }
+  bool isSolved(int cell) const { return solved[cell] != 0; }
+  long getBackups() const { return backups; }
+  int getVisitedCount() const;
+
+  // Writes utility and greedy policy of every visited cell into the world.
+  void apply(World &world) const;
+
+private:
+  float backup(int cell, int *action = nullptr) const;
+  float update(int cell);
+  bool checkSolved(int cell);
+
+  const TransitionModel &model;
+  float epsilon;
+  std::mt19937 rng;
+  std::vector<float> values;
+  std::vector<char> solved;
+  std::vector<char> visited;
+  std::vector<int> marks; // checkSolved generation of each cell
+  int generation;
+  long backups;
+  std::vector<int> trajectory;
+  std::vector<int> open;
+  std::vector<int> closed;
+};
+
+#endif // RTDP_HPP
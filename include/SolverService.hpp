@@ -0,0 +1,78 @@
+#ifndef SOLVER_SERVICE_HPP
+#define SOLVER_SERVICE_HPP
+
+#include "PathQuery.hpp"
+#include "TransitionModel.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Long running solver answering requests over a Unix domain socket.
+//
+// Every message is a frame: a 4 byte big endian payload length followed by
+// the payload. The first payload line is the command:
+//   SOLVE\n<world file>          -> OK <hash> <tiles>\n<table>
+//   RESOLVE <hash>\n<edit lines>  -> same as SOLVE for the edited world
+//   POLICY <hash> <x> <y>        -> OK <policy> <utility>
+//   PATH <hash> <x> <y> [<x> <y> ...]
+//                                -> OK <paths>\n<end> <steps> <x>,<y> ...
+//   SHUTDOWN                     -> OK
+// Failures are answered with "ERR <message>". Worlds are cached by the hash
+// of their normalised source together with their model and last solution.
+// Every connection is served by its own thread, requests are handled one at
+// a time.
+class SolverService {
+public:
+  explicit SolverService(size_t cacheCapacity = 64);
+
+  // Handles one request payload and returns the response payload.
+  std::string handle(const std::string &request);
+  // Accepts connections on `socketPath` until a SHUTDOWN request.
+  void serve(const std::string &socketPath);
+
+  static uint64_t hashSource(const std::string &source);
+
+  // Frame codec of the socket protocol. readFrame fails on end of stream,
+  // on a truncated frame and on payloads over kMaxFrameSize.
+  static const uint32_t kMaxFrameSize = 64u << 20;
+  static bool readFrame(int fd, std::string &payload);
+  static bool writeFrame(int fd, const std::string &payload);
+
+private:
+  struct CachedWorld {
+    std::string source;
+    std::unique_ptr<TransitionModel> model;
+    std::vector<float> utilities;
+    std::vector<char> policy;
+    std::unique_ptr<PathQuery> paths; // built by the first PATH request
+    long tiles; // processed by AsyncValueIteration
+    uint64_t lastUsed;
+  };
+
+  void serveClient(int client);
+  std::string solve(const std::string &source, const CachedWorld *warmStart);
+  std::string policyQuery(std::istream &args);
+  std::string pathQuery(std::istream &args);
+  CachedWorld &lookup(uint64_t hash);
+  void evict();
+  std::string formatSolution(uint64_t hash, const CachedWorld &entry) const;
+
+  size_t cacheCapacity;
+  uint64_t clock;
+  std::atomic<bool> running;
+  std::unordered_map<uint64_t, CachedWorld> cache;
+
+  std::mutex requestMutex; // serialises handle() between connections
+  std::mutex clientsMutex;
+  std::condition_variable clientsDone;
+  std::set<int> clients; // open connections
+  int listener;
+};
+
+#endif // SOLVER_SERVICE_HPP
@@ -0,0 +1,132 @@
+#ifndef TRANSITION_MODEL_HPP
+#define TRANSITION_MODEL_HPP
+
+#include "World.hpp"
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Flat, index based copy of the World dynamics shared by the solvers.
+// Cells are numbered (y - 1) * width + (x - 1). Outcomes that leave the grid
+// or hit a forbidden cell are resolved to the cell itself when the model is
+// built, so solvers never have to check bounds. Actions and their outcome
+// stencils come from the world's ActionModel.
+class TransitionModel {
+public:
+  explicit TransitionModel(const World &world);
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  int size() const { return width * height; }
+  int getActionCount() const { return actionCount; }
+  int getOutcomeCount() const { return outcomeCount; }
+  int getReach() const { return reach; } // largest move of any outcome
+  float getGamma() const { return gamma; }
+
+  int cellIndex(int x, int y) const;
+  std::pair<int, int> cellCoordinates(int cell) const;
+
+  char getType(int cell) const { return types[cell]; }
+  float getReward(int cell) const { return rewards[cell]; }
+  bool isTerminal(int cell) const { return types[cell] == 'T'; }
+  // Terminal and forbidden cells keep their utility during value iteration.
+  bool isFixed(int cell) const {
+    return types[cell] == 'T' || types[cell] == 'F';
+  }
+  // Plain cells take the world default reward, 'T' and '*' cells their own.
+  bool usesDefaultReward(int cell) const {
+    return types[cell] != 'T' && types[cell] != '*' && types[cell] != 'F';
+  }
+  // Utility a fixed cell keeps and the starting utility of all other cells.
+  float getInitialValue(int cell) const;
+
+  char getActionSymbol(int action) const { return actionSymbols[action]; }
+  int getActionIndex(char symbol) const; // -1 for unknown symbols
+
+  // Target cells of all outcomes of `action` taken in `cell`.
+  const int *getTargets(int cell, int action) const {
+    return &targets[(cell * actionCount + action) * outcomeCount];
+  }
+  float getWeight(int action, int outcome) const {
+    return weights[action * outcomeCount + outcome];
+  }
+  // ActionOutcome::parameter of the outcome, -1 for explicit weights.
+  int getWeightParameter(int action, int outcome) const {
+    return parameters[action * outcomeCount + outcome];
+  }
+
+  // Target of one random outcome of `action` taken in `cell`, or -1 when the
+  // draw falls on probability missing from the weights, which ends a
+  // trajectory like the 0 that mass adds in backup().
+  template <class RNG> int sampleOutcome(int cell, int action, RNG &rng) const {
+    const int *cellTargets = getTargets(cell, action);
+    std::uniform_real_distribution<float> unif(0.0f, 1.0f);
+    float sample = unif(rng);
+    for (int o = 0; o < outcomeCount; ++o) {
+      sample -= weights[action * outcomeCount + o];
+      if (sample < 0.0f) {
+        return cellTargets[o];
+      }
+    }
+    return -1;
+  }
+
+  // Bellman backup of one cell: reward + gamma * max_a sum_o p * V(target).
+  // Ties keep the first action, like World::getMaxQValue. `values` may be
+  // any array convertible to float, e.g. float or std::atomic<float>.
+  template <class V>
+  float backup(int cell, const V *values, float gamma,
+               int *bestAction = nullptr) const {
+    // The built-in stencils get loops with compile time trip counts.
+    if (actionCount == 4 && outcomeCount == 3) {
+      return backupStencil<4, 3>(cell, values, gamma, bestAction);
+    }
+    if (actionCount == 8 && outcomeCount == 3) {
+      return backupStencil<8, 3>(cell, values, gamma, bestAction);
+    }
+    return backupStencil<0, 0>(cell, values, gamma, bestAction);
+  }
+
+private:
+  // A and O of 0 take the counts of the model at run time.
+  template <int A, int O, class V>
+  float backupStencil(int cell, const V *values, float gamma,
+                      int *bestAction) const {
+    const int actions = A ? A : actionCount;
+    const int outcomes = O ? O : outcomeCount;
+    const int *cellTargets = &targets[cell * actions * outcomes];
+    float max_utility = std::numeric_limits<float>::lowest();
+    int max_action = -1;
+    for (int a = 0; a < actions; ++a) {
+      float utility = 0.0f;
+      for (int o = 0; o < outcomes; ++o) {
+        utility += weights[a * outcomes + o] *
+                   float(values[cellTargets[a * outcomes + o]]);
+      }
+      if (max_utility < utility) {
+        max_utility = utility;
+        max_action = a;
+      }
+    }
+    if (bestAction) {
+      *bestAction = max_action;
+    }
+    return rewards[cell] + gamma * max_utility;
+  }
+
+  int width;
+  int height;
+  int actionCount;
+  int outcomeCount;
+  int reach;
+  float gamma;
+  std::vector<char> types;
+  std::vector<float> rewards;
+  std::vector<char> actionSymbols;
+  std::vector<float> weights;
+  std::vector<int> parameters;
+  std::vector<int> targets;
+};
+
+#endif // TRANSITION_MODEL_HPP
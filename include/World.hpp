@@ -1,9 +1,15 @@
 #ifndef WORLD_HPP
 #define WORLD_HPP
 
+#include "ActionModel.hpp"
 #include "DataLoader.hpp"
+#include "EligibilityTraces.hpp"
+#include "Exploration.hpp"
 #include "Policy.hpp"
+#include "QTable.hpp"
 #include <iomanip> // for std::setw
+#include <memory>
+#include <random>
 #include <vector>
 
 struct State {
@@ -11,8 +17,6 @@ struct State {
   char type;
   float reward;
   char policy;
-  std::map<char, uint32_t> visits;
-  std::map<char, float> q;
   // std::pair<char, std::vector<std::array<int, 2>>> policies;
 };
 
@@ -28,7 +32,9 @@ public:
   float getValue(int x, int y) const; // Get the utility of a specific state
   char getType(int x, int y) const;   // Get the policy of a specific state
   int getWidth() const { return width; }
-  int getHeight() const { return width; }
+  int getHeight() const { return height; }
+  float getGamma() const { return gamma; }
+  const ActionModel &getActionModel() const { return actionModel; }
 
   void valueIteration(float gamma, float epsilon);
   float getMaxQValue(int x, int y);
@@ -38,13 +44,39 @@ public:
   float getReward(int x, int y) const;
   void addVisit(int x, int y, char action);
   uint32_t getVisits(int x, int y, char action) const;
-  void QLearning(int start_x, int start_y, int &x, int& y);
+  // One episode of Q-learning from (x, y). Returns false when it was cut
+  // after `maxSteps` steps.
+  bool QLearning(int &x, int &y, int maxSteps);
+  // One episode of Watkins Q(lambda), or SARSA(lambda) when `sarsa` is set,
+  // from (x, y). Returns false when it was cut after `maxSteps` steps.
+  bool QLambda(int &x, int &y, float lambda, bool sarsa, int maxSteps);
+
+  // Action selection of QLearning and QLambda, epsilon-greedy by default.
+  void setExploration(const Exploration &exploration);
+  const Exploration &getExploration() const { return exploration; }
+
+  // Replaces the dense Q-values and visit counts of all cells with a hash
+  // table holding only the visited ones, limited to `maxBytes`. Call it
+  // before learning: the dense table is only allocated on first use, and
+  // values learned so far are dropped.
+  void useSparseQTable(size_t maxBytes);
+  // Null while the dense table is in use.
+  const QTable *getSparseQTable() const {
+    return sparseBytes ? qTable.get() : nullptr;
+  }
+  // Storage type of the Q-values: float (default), BFloat16 or Half. Like
+  // useSparseQTable it drops the values learned so far.
+  void setQPrecision(Precision precision);
 
   float getQValue(int x, int y, char action);
   void updateQValue(int x, int y, char action, float value);
 
   std::pair<int, int> getStart();
 
+  // Policy grid as text, top row first, '.' where there is no policy.
+  void savePolicy(const std::string &filename) const;
+  void loadPolicy(const std::string &filename);
+
 private:
   int width;
   int height;
@@ -57,11 +89,22 @@ private:
   float reward;
   float gamma;
   float epsilon;
-  float probabilities[3];
+  ActionModel actionModel;
+  EligibilityTraces traces;
+  Exploration exploration;
+  std::mt19937_64 rng;
+  std::unique_ptr<QTable> qTable;
+  Precision qPrecision = Precision::Float;
+  size_t sparseBytes = 0; // 0 for the dense table
+  std::vector<float> actionQ;         // scratch rows for chooseAction
+  std::vector<uint32_t> actionVisits;
   void initializeGrid();
+  char getBestQAction(int x, int y);
+  int getActionIndex(char action) const; // throws for unknown symbols
+  QTable &getQTable(); // the dense table unless useSparseQTable was called
+  QTable *createQTable() const;
 
-  std::pair<char, std::vector<std::array<int, 2>>> getRandomAction(int x,
-                                                                   int y);
+  char chooseAction(int x, int y);
   std::pair<int, int> execute_action(int start_x, int start_y, char action);
 };
 
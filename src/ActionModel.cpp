@@ -0,0 +1,92 @@
+#include "ActionModel.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+ActionModel ActionModel::fourConnected(float p1, float p2, float p3) {
+  // Same stencils and order as the original hard-coded dynamics.
+  ActionModel model;
+  model.actions = {
+      {'<', {{0, -1, p2, 1}, {-1, 0, p1, 0}, {0, 1, p3, 2}}},
+      {'>', {{0, -1, p2, 1}, {1, 0, p1, 0}, {0, 1, p3, 2}}},
+      {'^', {{-1, 0, p2, 1}, {0, 1, p1, 0}, {1, 0, p3, 2}}},
+      {'v', {{-1, 0, p2, 1}, {0, -1, p1, 0}, {1, 0, p3, 2}}},
+  };
+  return model;
+}
+
+ActionModel ActionModel::eightConnected(float p1, float p2, float p3) {
+  // Compass directions counter-clockwise from east.
+  const char symbols[8] = {'>', '9', '^', '7', '<', '1', 'v', '3'};
+  const int moves[8][2] = {{1, 0},  {1, 1},   {0, 1},  {-1, 1},
+                           {-1, 0}, {-1, -1}, {0, -1}, {1, -1}};
+  const int order[8] = {4, 0, 2, 6, 3, 1, 5, 7}; // '<', '>', '^', 'v' first
+
+  ActionModel model;
+  for (int i : order) {
+    const int ccw = (i + 1) % 8;
+    const int cw = (i + 7) % 8;
+    model.actions.push_back(
+        {symbols[i],
+         {{moves[ccw][0], moves[ccw][1], p2, 1},
+          {moves[i][0], moves[i][1], p1, 0},
+          {moves[cw][0], moves[cw][1], p3, 2}}});
+  }
+  return model;
+}
+
+void ActionModel::setAction(const ActionDefinition &action) {
+  for (auto &existing : actions) {
+    if (existing.symbol == action.symbol) {
+      existing = action;
+      return;
+    }
+  }
+  actions.push_back(action);
+}
+
+int ActionModel::getOutcomeCount() const {
+  size_t count = 0;
+  for (const auto &action : actions) {
+    count = std::max(count, action.outcomes.size());
+  }
+  return count;
+}
+
+int ActionModel::getReach() const {
+  int reach = 0;
+  for (const auto &action : actions) {
+    for (const auto &outcome : action.outcomes) {
+      reach = std::max(reach, std::max(std::abs(outcome.dx),
+                                       std::abs(outcome.dy)));
+    }
+  }
+  return reach;
+}
+
+int ActionModel::getIndex(char symbol) const {
+  for (size_t a = 0; a < actions.size(); ++a) {
+    if (actions[a].symbol == symbol) {
+      return a;
+    }
+  }
+  return -1;
+}
+
+std::pair<int, int> ActionModel::getMove(int action) const {
+  const auto &outcomes = actions[action].outcomes;
+  if (outcomes.empty()) {
+    return {0, 0};
+  }
+  for (const auto &outcome : outcomes) {
+    if (outcome.parameter == 0) {
+      return {outcome.dx, outcome.dy}; // intended move of a P stencil
+    }
+  }
+  auto best = outcomes.begin();
+  for (auto it = outcomes.begin(); it != outcomes.end(); ++it) {
+    if (it->probability > best->probability) {
+      best = it;
+    }
+  }
+  return {best->dx, best->dy};
+}
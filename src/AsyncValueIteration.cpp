@@ -0,0 +1,251 @@
+#include "AsyncValueIteration.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+// A tile that has not converged after this many sweeps is queued again, so
+// it picks up fresh boundary values instead of converging against stale
+// ones.
+const int kMaxTileSweeps = 4;
+} // namespace
+
+template <class T>
+AsyncValueIteration<T>::AsyncValueIteration(const TransitionModel &model,
+                                            int tileSize)
+    : model(model),
+      tileSize(std::max(tileSize, std::max(model.getReach(), 1))),
+      tilesX((model.getWidth() + this->tileSize - 1) / this->tileSize),
+      tilesY((model.getHeight() + this->tileSize - 1) / this->tileSize),
+      values(new Value[model.size()]),
+      tileStates(new std::atomic<unsigned char>[tilesX * tilesY]),
+      notified(new float[model.size()]), pending(0), processed(0), steals(0) {
+  for (int cell = 0; cell < model.size(); ++cell) {
+    values[cell].store(model.getInitialValue(cell));
+    notified[cell] = values[cell];
+  }
+  for (int tile = 0; tile < tilesX * tilesY; ++tile) {
+    tileStates[tile].store(0, std::memory_order_relaxed);
+  }
+}
+
+template <class T> void AsyncValueIteration<T>::setValue(int cell, float value) {
+  if (!model.isFixed(cell)) {
+    values[cell].store(value);
+    notified[cell] = values[cell];
+  }
+}
+
+template <class T>
+long AsyncValueIteration<T>::solve(float epsilon, unsigned threads) {
+  threads = std::max(threads, 1u);
+  workers.clear();
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back(new Worker);
+  }
+  pending = 0;
+  processed = 0;
+  steals = 0;
+
+  // Every tile with a free cell starts dirty, in contiguous blocks per
+  // thread so neighbouring tiles usually stay on one thread.
+  const int tiles = tilesX * tilesY;
+  for (int tile = 0; tile < tiles; ++tile) {
+    const int x0 = tile % tilesX * tileSize;
+    const int y0 = tile / tilesX * tileSize;
+    bool free = false;
+    for (int y = y0; y < std::min(y0 + tileSize, model.getHeight()); ++y) {
+      for (int x = x0; x < std::min(x0 + tileSize, model.getWidth()); ++x) {
+        free = free || !model.isFixed(y * model.getWidth() + x);
+      }
+    }
+    if (free) {
+      markDirty(tile, static_cast<unsigned>(long(tile) * threads / tiles));
+    }
+  }
+
+  std::vector<std::thread> pool;
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back(&AsyncValueIteration<T>::work, this, t, epsilon);
+  }
+  work(0, epsilon);
+  for (auto &thread : pool) {
+    thread.join();
+  }
+  return processed;
+}
+
+template <class T> char AsyncValueIteration<T>::getPolicy(int cell) const {
+  if (model.isFixed(cell)) {
+    return ' ';
+  }
+  int action;
+  model.backup(cell, values.get(), model.getGamma(), &action);
+  return model.getActionSymbol(action);
+}
+
+template <class T> void AsyncValueIteration<T>::apply(World &world) const {
+  for (int cell = 0; cell < model.size(); ++cell) {
+    const auto xy = model.cellCoordinates(cell);
+    world.updateUtility(xy.first, xy.second, values[cell]);
+    world.updatePolicy(xy.first, xy.second, getPolicy(cell));
+  }
+}
+
+template <class T>
+void AsyncValueIteration<T>::work(unsigned self, float epsilon) {
+  int tile;
+  while (true) {
+    if (popTile(self, tile)) {
+      processTile(tile, self, epsilon);
+      pending.fetch_sub(1);
+    } else if (pending.load() == 0) {
+      return;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// Own tiles are taken in FIFO order: a LIFO queue lets two neighbouring
+// tiles hand work back and forth while the rest of the grid waits.
+template <class T>
+bool AsyncValueIteration<T>::popTile(unsigned self, int &tile) {
+  {
+    Worker &own = *workers[self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tiles.empty()) {
+      tile = own.tiles.front();
+      own.tiles.pop_front();
+      return true;
+    }
+  }
+  for (size_t k = 1; k < workers.size(); ++k) {
+    Worker &victim = *workers[(self + k) % workers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tiles.empty()) {
+      tile = victim.tiles.back();
+      victim.tiles.pop_back();
+      ++steals;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class T>
+void AsyncValueIteration<T>::markDirty(int tile, unsigned worker) {
+  // A tile being swept is only flagged; processTile queues it again when the
+  // sweep is done, so no other thread can take it meanwhile.
+  unsigned char state = tileStates[tile].load();
+  while (true) {
+    if (state & (kQueued | kRerun)) {
+      return;
+    }
+    const unsigned char next = (state & kRunning) ? state | kRerun : kQueued;
+    if (tileStates[tile].compare_exchange_weak(state, next)) {
+      if (next == kQueued) {
+        enqueue(tile, worker);
+      }
+      return;
+    }
+  }
+}
+
+template <class T>
+void AsyncValueIteration<T>::enqueue(int tile, unsigned worker) {
+  pending.fetch_add(1);
+  Worker &target = *workers[worker];
+  std::lock_guard<std::mutex> lock(target.mutex);
+  target.tiles.push_back(tile);
+}
+
+template <class T>
+void AsyncValueIteration<T>::processTile(int tile, unsigned worker,
+                                         float epsilon) {
+  // From now on a neighbour changing our inputs flags the tile for a rerun.
+  tileStates[tile].store(kRunning);
+  ++processed;
+
+  const int width = model.getWidth();
+  const int tx = tile % tilesX;
+  const int ty = tile / tilesX;
+  const int x0 = tx * tileSize;
+  const int y0 = ty * tileSize;
+  const int x1 = std::min(x0 + tileSize, width);
+  const int y1 = std::min(y0 + tileSize, model.getHeight());
+
+  bool converged = false;
+  for (int sweep = 0; sweep < kMaxTileSweeps && !converged; ++sweep) {
+    float max_delta = 0.0f;
+    for (int y = y0; y < y1; ++y) {
+      for (int x = x0; x < x1; ++x) {
+        const int cell = y * width + x;
+        if (model.isFixed(cell)) {
+          continue;
+        }
+        // The change is measured after rounding to T, so a value that T
+        // cannot resolve any further counts as converged.
+        const float oldValue = values[cell];
+        values[cell].store(model.backup(cell, values.get(), model.getGamma()));
+        max_delta = std::max(max_delta, std::abs(values[cell] - oldValue));
+      }
+    }
+    converged = max_delta < epsilon;
+  }
+
+  // Only cells within reach of the tile border feed other tiles. The tile is
+  // at least reach wide, so the neighbours are one tile away. Changes are
+  // measured against the value last passed on, so small moves that add up
+  // are not lost.
+  const int reach = model.getReach();
+  bool changed[3][3] = {};
+  for (int y = y0; y < y1; ++y) {
+    for (int x = x0; x < x1; ++x) {
+      const bool left = x < x0 + reach;
+      const bool right = x >= x1 - reach;
+      const bool bottom = y < y0 + reach;
+      const bool top = y >= y1 - reach;
+      if (!left && !right && !bottom && !top) {
+        continue;
+      }
+      const int cell = y * width + x;
+      const float value = values[cell];
+      if (std::abs(value - notified[cell]) <= epsilon) {
+        continue;
+      }
+      notified[cell] = value;
+      for (int dy = -1; dy <= 1; ++dy) {
+        for (int dx = -1; dx <= 1; ++dx) {
+          if ((dx == -1 && !left) || (dx == 1 && !right) ||
+              (dy == -1 && !bottom) || (dy == 1 && !top)) {
+            continue;
+          }
+          changed[dy + 1][dx + 1] = true;
+        }
+      }
+    }
+  }
+  for (int dy = -1; dy <= 1; ++dy) {
+    for (int dx = -1; dx <= 1; ++dx) {
+      const int nx = tx + dx;
+      const int ny = ty + dy;
+      if ((dx != 0 || dy != 0) && changed[dy + 1][dx + 1] && nx >= 0 &&
+          nx < tilesX && ny >= 0 && ny < tilesY) {
+        markDirty(ny * tilesX + nx, worker);
+      }
+    }
+  }
+
+  unsigned char state = kRunning;
+  if (converged && tileStates[tile].compare_exchange_strong(state, 0)) {
+    return;
+  }
+  // Not converged, or flagged for a rerun while it was swept.
+  tileStates[tile].store(kQueued);
+  enqueue(tile, worker);
+}
+
+template class AsyncValueIteration<float>;
+template class AsyncValueIteration<BFloat16>;
+template class AsyncValueIteration<Half>;
@@ -0,0 +1,249 @@
+#include "BatchSolver.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+std::vector<SweepScenario> loadSweepScenarios(const std::string &filename,
+                                              const DataLoader &defaults) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+
+  const bool hasProbs = defaults.hasProbabilities();
+  const auto probs = hasProbs ? defaults.getProbabilities()
+                              : std::make_tuple(0.0f, 0.0f, 0.0f);
+  std::vector<SweepScenario> scenarios;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream iss(line);
+    std::string label;
+    if (!(iss >> label) || label[0] == '#') {
+      continue;
+    }
+
+    SweepScenario scenario = {defaults.getGamma(), defaults.getDefaultReward(),
+                              std::get<0>(probs), std::get<1>(probs),
+                              std::get<2>(probs), hasProbs};
+    do {
+      if (label == "G") {
+        if (!(iss >> scenario.gamma)) {
+          throw std::runtime_error("Invalid format for gamma");
+        }
+        if (scenario.gamma <= 0.0f || scenario.gamma > 1.0f) {
+          throw std::runtime_error("Invalid gamma utility");
+        }
+      } else if (label == "R") {
+        if (!(iss >> scenario.reward)) {
+          throw std::runtime_error("Invalid format for default reward");
+        }
+      } else if (label == "P") {
+        if (!(iss >> scenario.p1 >> scenario.p2 >> scenario.p3)) {
+          throw std::runtime_error("Invalid format for probabilities");
+        }
+        if (scenario.p1 < 0.0f || scenario.p2 < 0.0f || scenario.p3 < 0.0f ||
+            scenario.p1 + scenario.p2 + scenario.p3 > 1.0f) {
+          throw std::runtime_error("Invalid probabilities values");
+        }
+        scenario.hasProbabilities = true;
+      } else {
+        throw std::runtime_error("Unknown sweep label: " + label);
+      }
+    } while (iss >> label);
+    scenarios.push_back(scenario);
+  }
+
+  if (scenarios.empty()) {
+    throw std::runtime_error("No scenarios in sweep file: " + filename);
+  }
+  return scenarios;
+}
+
+template <class T>
+BatchSolver<T>::BatchSolver(const TransitionModel &model,
+                            const std::vector<SweepScenario> &scenarios)
+    : model(model), scenarios(scenarios), scenarioCount(scenarios.size()),
+      stride((scenarios.size() + kLanes - 1) / kLanes * kLanes),
+      iterations(scenarios.size(), -1) {
+  const int actions = model.getActionCount();
+  const int outcomes = model.getOutcomeCount();
+
+  // Padding lanes keep zero weights and rewards, so they stay at zero.
+  values.assign(model.size() * stride, T(0.0f));
+  rewards.assign(model.size() * stride, T(0.0f));
+  weights.assign(actions * outcomes * stride, 0);
+  gammas.assign(stride, 0);
+
+  for (int s = 0; s < scenarioCount; ++s) {
+    const SweepScenario &scenario = scenarios[s];
+    gammas[s] = scenario.gamma;
+
+    // Outcomes taken from P follow the scenario, explicit ones keep the
+    // weight of the model.
+    const float probabilities[3] = {scenario.p1, scenario.p2, scenario.p3};
+    for (int a = 0; a < actions; ++a) {
+      for (int o = 0; o < outcomes; ++o) {
+        const int parameter = model.getWeightParameter(a, o);
+        weights[(a * outcomes + o) * stride + s] =
+            parameter >= 0 ? probabilities[parameter] : model.getWeight(a, o);
+      }
+    }
+
+    for (int cell = 0; cell < model.size(); ++cell) {
+      values[cell * stride + s] = T(model.getInitialValue(cell));
+      rewards[cell * stride + s] = T(model.usesDefaultReward(cell)
+                                         ? scenario.reward
+                                         : model.getReward(cell));
+    }
+  }
+}
+
+template <class T>
+int BatchSolver<T>::solve(Accumulator epsilon, int maxIterations) {
+  const int actions = model.getActionCount();
+  const int outcomes = model.getOutcomeCount();
+  std::vector<Accumulator> deltas(stride);
+
+  int sweep = 0;
+  bool converged = false;
+  while (!converged && sweep < maxIterations) {
+    std::fill(deltas.begin(), deltas.end(), Accumulator(0));
+    if (actions == 4 && outcomes == 3) {
+      sweepCells<4, 3>(deltas);
+    } else if (actions == 8 && outcomes == 3) {
+      sweepCells<8, 3>(deltas);
+    } else {
+      sweepCells<0, 0>(deltas);
+    }
+    ++sweep;
+
+    converged = true;
+    for (int s = 0; s < scenarioCount; ++s) {
+      if (deltas[s] < epsilon) {
+        if (iterations[s] < 0) {
+          iterations[s] = sweep;
+        }
+      } else {
+        iterations[s] = -1;
+        converged = false;
+      }
+    }
+  }
+  return sweep;
+}
+
+template <class T>
+template <int A, int O>
+void BatchSolver<T>::sweepCells(std::vector<Accumulator> &deltas) {
+  const int actions = A ? A : model.getActionCount();
+  const int outcomes = O ? O : model.getOutcomeCount();
+
+  for (int cell = 0; cell < model.size(); ++cell) {
+    if (model.isFixed(cell)) {
+      continue;
+    }
+    T *value = &values[cell * stride];
+    const T *reward = &rewards[cell * stride];
+    const int *targets = model.getTargets(cell, 0);
+
+    // Fixed size lane blocks let the compiler keep each block in one
+    // vector register.
+    for (int lane = 0; lane < stride; lane += kLanes) {
+      Accumulator best[kLanes];
+      for (int k = 0; k < kLanes; ++k) {
+        best[k] = std::numeric_limits<Accumulator>::lowest();
+      }
+
+      for (int a = 0; a < actions; ++a) {
+        Accumulator utility[kLanes] = {};
+        for (int o = 0; o < outcomes; ++o) {
+          const T *target = &values[targets[a * outcomes + o] * stride + lane];
+          const Accumulator *weight =
+              &weights[(a * outcomes + o) * stride + lane];
+          for (int k = 0; k < kLanes; ++k) {
+            utility[k] += weight[k] * static_cast<Accumulator>(target[k]);
+          }
+        }
+        for (int k = 0; k < kLanes; ++k) {
+          best[k] = std::max(best[k], utility[k]);
+        }
+      }
+
+      // The change is measured after rounding to T, so 16-bit storage
+      // converges once the stored values stop moving.
+      for (int k = 0; k < kLanes; ++k) {
+        const T newValue = T(static_cast<Accumulator>(reward[lane + k]) +
+                             gammas[lane + k] * best[k]);
+        const Accumulator delta =
+            std::abs(static_cast<Accumulator>(newValue) -
+                     static_cast<Accumulator>(value[lane + k]));
+        deltas[lane + k] = std::max(deltas[lane + k], delta);
+        value[lane + k] = newValue;
+      }
+    }
+  }
+}
+
+template <class T>
+char BatchSolver<T>::getPolicy(int scenario, int cell) const {
+  if (model.isFixed(cell)) {
+    return ' ';
+  }
+  const int outcomes = model.getOutcomeCount();
+  Accumulator max_utility = std::numeric_limits<Accumulator>::lowest();
+  char max_policy = ' ';
+  for (int a = 0; a < model.getActionCount(); ++a) {
+    const int *targets = model.getTargets(cell, a);
+    Accumulator utility = 0;
+    for (int o = 0; o < outcomes; ++o) {
+      const T target = values[targets[o] * stride + scenario];
+      utility += weights[(a * outcomes + o) * stride + scenario] *
+                 static_cast<Accumulator>(target);
+    }
+    if (max_utility < utility) {
+      max_utility = utility;
+      max_policy = model.getActionSymbol(a);
+    }
+  }
+  return max_policy;
+}
+
+template <class T>
+void BatchSolver<T>::writeTable(int scenario, std::ostream &out) const {
+  const SweepScenario &s = scenarios[scenario];
+  out << "# G " << s.gamma << " R " << s.reward;
+  if (s.hasProbabilities) {
+    out << " P " << s.p1 << " " << s.p2 << " " << s.p3;
+  }
+  out << "\n";
+  out << "# iterations " << iterations[scenario] << "\n";
+  out << "x y type policy utility\n";
+  for (int cell = 0; cell < model.size(); ++cell) {
+    const auto xy = model.cellCoordinates(cell);
+    const char type = model.getType(cell) == ' ' ? '.' : model.getType(cell);
+    const char policy = getPolicy(scenario, cell);
+    out << xy.first << " " << xy.second << " " << type << " "
+        << (policy == ' ' ? '.' : policy) << " " << getValue(scenario, cell)
+        << "\n";
+  }
+}
+
+template <class T>
+void BatchSolver<T>::writeTables(const std::string &prefix) const {
+  for (int s = 0; s < scenarioCount; ++s) {
+    const std::string filename = prefix + std::to_string(s) + ".txt";
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+      throw std::runtime_error("Cannot open file: " + filename);
+    }
+    writeTable(s, file);
+  }
+}
+
+template class BatchSolver<float>;
+template class BatchSolver<double>;
+template class BatchSolver<BFloat16>;
+template class BatchSolver<Half>;
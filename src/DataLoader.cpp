@@ -6,13 +6,16 @@ void DataLoader::load(const std::string& filename) {
         throw std::runtime_error("Cannot open file: " + filename);
     }
 
+    load(file);
+    file.close();
+}
+
+void DataLoader::load(std::istream& input) {
     std::string line;
-    while (std::getline(file, line)) {
+    while (std::getline(input, line)) {
         parseLine(line);
     }
 
-    file.close();
-
     validateData();
 }
 
@@ -75,6 +78,45 @@ void DataLoader::parseLine(const std::string& line) {
             throw std::runtime_error("Invalid format for forbidden state");
         }
         forbiddenStates.push_back(fs);
+    } else if (label == "M") {
+        if (!(iss >> moveModel)) {
+            throw std::runtime_error("Invalid format for move model");
+        }
+        if (moveModel != 0 && moveModel != 4 && moveModel != 8) {
+            throw std::runtime_error("Invalid move model, expected 0, 4 or 8");
+        }
+    } else if (label == "A") {
+        ActionDefinition action;
+        std::vector<float> values;
+        float value;
+        if (!(iss >> action.symbol)) {
+            throw std::runtime_error("Invalid format for action");
+        }
+        while (iss >> value) {
+            values.push_back(value);
+        }
+        if (!iss.eof() || values.empty() || values.size() % 3 != 0) {
+            throw std::runtime_error("Invalid format for action");
+        }
+        if (action.symbol == '.') {
+            throw std::runtime_error("Action symbol '.' is reserved");
+        }
+        float total = 0.0f;
+        for (size_t i = 0; i < values.size(); i += 3) {
+            const ActionOutcome outcome = {static_cast<int>(values[i + 1]),
+                                           static_cast<int>(values[i + 2]),
+                                           values[i], -1};
+            if (outcome.probability < 0.0f ||
+                outcome.dx != values[i + 1] || outcome.dy != values[i + 2]) {
+                throw std::runtime_error("Invalid action outcome values");
+            }
+            total += outcome.probability;
+            action.outcomes.push_back(outcome);
+        }
+        if (total > 1.0f + 1e-6f) {
+            throw std::runtime_error("Invalid action probabilities values");
+        }
+        customActions.push_back(action);
     } else {
         throw std::runtime_error("Unknown label: " + label);
     }
@@ -84,9 +126,22 @@ void DataLoader::validateData() const {
     if (!worldSizeSet) {
         throw std::runtime_error("World size is not set");
     }
-    if (!probabilitiesSet) {
+    // Keeps cell indices of the flat solvers well inside int.
+    if (worldWidth < 1 || worldHeight < 1 || worldWidth > kMaxWorldSide ||
+        worldHeight > kMaxWorldSide ||
+        static_cast<long long>(worldWidth) * worldHeight > kMaxWorldCells) {
+        throw std::runtime_error("Invalid world size");
+    }
+    if (startStateSet && (startX < 1 || startX > worldWidth || startY < 1 ||
+                          startY > worldHeight)) {
+        throw std::runtime_error("Start state out of world bounds");
+    }
+    if (!probabilitiesSet && moveModel != 0) {
         throw std::runtime_error("Probabilities are not set");
     }
+    if (moveModel == 0 && customActions.empty()) {
+        throw std::runtime_error("At least one action is required");
+    }
     if (!defaultRewardSet) {
         throw std::runtime_error("Default reward is not set");
     }
@@ -118,7 +173,17 @@ void DataLoader::printData() const {
     if (startStateSet) {
         std::cout << "Start state: (" << startX << ", " << startY << ")" << std::endl;
     }
-    std::cout << "Probabilities: p1=" << p1 << ", p2=" << p2 << ", p3=" << p3 << std::endl;
+    if (probabilitiesSet) {
+        std::cout << "Probabilities: p1=" << p1 << ", p2=" << p2 << ", p3=" << p3 << std::endl;
+    }
+    std::cout << "Move model: " << moveModel << std::endl;
+    for (const auto& action : customActions) {
+        std::cout << "  Action " << action.symbol << ":";
+        for (const auto& outcome : action.outcomes) {
+            std::cout << " " << outcome.probability << " (" << outcome.dx << ", " << outcome.dy << ")";
+        }
+        std::cout << std::endl;
+    }
     std::cout << "Default reward: " << defaultReward << std::endl;
     if (gammaSet) {
         std::cout << "Gamma: " << gamma << std::endl;
@@ -156,6 +221,10 @@ std::pair<int, int> DataLoader::getStartState() const {
     return {startX, startY};
 }
 
+bool DataLoader::hasProbabilities() const {
+    return probabilitiesSet;
+}
+
 std::tuple<float, float, float> DataLoader::getProbabilities() const {
     if (!probabilitiesSet) {
         throw std::runtime_error("Probabilities are not set");
@@ -188,4 +257,17 @@ const std::vector<SpecialState>& DataLoader::getSpecialStates() const {
 
 const std::vector<ForbiddenState>& DataLoader::getForbiddenStates() const {
     return forbiddenStates;
+}
+
+ActionModel DataLoader::getActionModel() const {
+    ActionModel model;
+    if (moveModel == 4) {
+        model = ActionModel::fourConnected(p1, p2, p3);
+    } else if (moveModel == 8) {
+        model = ActionModel::eightConnected(p1, p2, p3);
+    }
+    for (const auto& action : customActions) {
+        model.setAction(action);
+    }
+    return model;
 }
\ No newline at end of file
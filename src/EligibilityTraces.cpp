@@ -0,0 +1,24 @@
+#include "EligibilityTraces.hpp"
+
+EligibilityTraces::EligibilityTraces(float threshold) : threshold(threshold) {}
+
+void EligibilityTraces::visit(int x, int y, char action) {
+  for (auto &trace : traces) {
+    if (trace.x == x && trace.y == y && trace.action == action) {
+      trace.eligibility = 1.0f;
+      return;
+    }
+  }
+  traces.push_back({x, y, action, 1.0f});
+}
+
+void EligibilityTraces::decay(float factor) {
+  size_t kept = 0;
+  for (size_t i = 0; i < traces.size(); ++i) {
+    traces[i].eligibility *= factor;
+    if (traces[i].eligibility >= threshold) {
+      traces[kept++] = traces[i];
+    }
+  }
+  traces.resize(kept);
+}
@@ -0,0 +1,94 @@
+#include "Exploration.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+ExplorationKind parseExplorationKind(const std::string &name) {
+  if (name == "eps" || name == "epsilon") {
+    return ExplorationKind::EpsilonGreedy;
+  } else if (name == "decay") {
+    return ExplorationKind::DecayingEpsilon;
+  } else if (name == "ucb") {
+    return ExplorationKind::UCB1;
+  } else if (name == "count") {
+    return ExplorationKind::CountBonus;
+  }
+  throw std::runtime_error("Unknown exploration: " + name);
+}
+
+Exploration::Exploration(ExplorationKind kind, float epsilon)
+    : kind(kind), epsilon(epsilon), decay(0.995f), minEpsilon(0.01f),
+      ucbConstant(std::sqrt(2.0f)), bonus(0.1f), episode(0) {}
+
+void Exploration::setDecay(float decay, float minEpsilon) {
+  if (decay <= 0.0f || decay > 1.0f) {
+    throw std::runtime_error("Invalid epsilon decay");
+  }
+  this->decay = decay;
+  this->minEpsilon = minEpsilon;
+}
+
+float Exploration::getEpsilon() const {
+  if (kind != ExplorationKind::DecayingEpsilon) {
+    return epsilon;
+  }
+  return std::max(minEpsilon,
+                  epsilon * static_cast<float>(std::pow(decay, episode)));
+}
+
+int Exploration::select(const float *q, const uint32_t *visits, int count,
+                        int greedy, std::mt19937_64 &rng) const {
+  if (kind == ExplorationKind::UCB1 || kind == ExplorationKind::CountBonus) {
+    return selectOptimistic(q, visits, count, rng);
+  }
+  std::uniform_real_distribution<float> unif(0.0f, 1.0f);
+  if (greedy < 0 || unif(rng) < getEpsilon()) {
+    return std::uniform_int_distribution<int>(0, count - 1)(rng);
+  }
+  return greedy;
+}
+
+int Exploration::selectOptimistic(const float *q, const uint32_t *visits,
+                                  int count, std::mt19937_64 &rng) const {
+  if (kind == ExplorationKind::UCB1) {
+    // Every action is tried once before the bound is defined; a uniform pick
+    // among the untried ones without building a list.
+    int untried = 0;
+    int choice = -1;
+    uint64_t total = 0;
+    for (int a = 0; a < count; ++a) {
+      total += visits[a];
+      if (visits[a] == 0 &&
+          std::uniform_int_distribution<int>(0, untried++)(rng) == 0) {
+        choice = a;
+      }
+    }
+    if (choice >= 0) {
+      return choice;
+    }
+
+    const float logTotal = std::log(static_cast<float>(total));
+    float best = std::numeric_limits<float>::lowest();
+    for (int a = 0; a < count; ++a) {
+      const float score =
+          q[a] + ucbConstant * std::sqrt(logTotal / visits[a]);
+      if (score > best) {
+        best = score;
+        choice = a;
+      }
+    }
+    return choice;
+  }
+
+  float best = std::numeric_limits<float>::lowest();
+  int choice = 0;
+  for (int a = 0; a < count; ++a) {
+    const float score = q[a] + bonus / std::sqrt(visits[a] + 1.0f);
+    if (score > best) {
+      best = score;
+      choice = a;
+    }
+  }
+  return choice;
+}
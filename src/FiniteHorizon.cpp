@@ -0,0 +1,163 @@
+#include "FiniteHorizon.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+const char kMagic[4] = {'F', 'H', 'P', '1'};
+
+void writeInt(std::ostream &out, int32_t value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+int32_t readInt(std::istream &in) {
+  int32_t value;
+  if (!in.read(reinterpret_cast<char *>(&value), sizeof(value))) {
+    throw std::runtime_error("Truncated policy stream");
+  }
+  return value;
+}
+} // namespace
+
+template <class T>
+FiniteHorizon<T>::FiniteHorizon(const TransitionModel &model, int horizon)
+    : model(model), horizon(horizon),
+      bits(bitsPerAction(model.getActionCount())), previous(model.size()),
+      current(model.size()), actions(model.size(), 0),
+      packed((static_cast<size_t>(model.size()) * bits + 7) / 8) {
+  if (horizon < 0) {
+    throw std::runtime_error("Invalid horizon");
+  }
+  // With no steps left only terminal cells are worth anything; '*' cells
+  // collect their reward like plain cells, when a step starts there.
+  for (int cell = 0; cell < model.size(); ++cell) {
+    current[cell] = T(model.isTerminal(cell) ? model.getReward(cell) : 0.0f);
+  }
+}
+
+template <class T> int FiniteHorizon<T>::bitsPerAction(int actionCount) {
+  int bits = 1;
+  while ((1 << bits) < actionCount) {
+    ++bits;
+  }
+  return bits;
+}
+
+template <class T>
+void FiniteHorizon<T>::solve(std::ostream *policyOut, int keepStages) {
+  const int stored =
+      keepStages < 0 ? horizon : std::min(keepStages, horizon);
+  if (policyOut) {
+    policyOut->write(kMagic, sizeof(kMagic));
+    writeInt(*policyOut, model.getWidth());
+    writeInt(*policyOut, model.getHeight());
+    writeInt(*policyOut, model.getActionCount());
+    writeInt(*policyOut, bits);
+    writeInt(*policyOut, horizon);
+    writeInt(*policyOut, stored);
+  }
+
+  const float gamma = model.getGamma();
+  for (int stepsToGo = 1; stepsToGo <= horizon; ++stepsToGo) {
+    previous.swap(current);
+    for (int cell = 0; cell < model.size(); ++cell) {
+      if (model.isFixed(cell)) {
+        current[cell] = previous[cell];
+        actions[cell] = 0;
+        continue;
+      }
+      int action;
+      current[cell] = T(model.backup(cell, previous.data(), gamma, &action));
+      actions[cell] = static_cast<char>(action);
+    }
+
+    if (!policyOut || stepsToGo <= horizon - stored) {
+      continue;
+    }
+    std::fill(packed.begin(), packed.end(), 0);
+    for (int cell = 0; cell < model.size(); ++cell) {
+      const size_t bit = static_cast<size_t>(cell) * bits;
+      const uint32_t value = static_cast<uint32_t>(actions[cell]);
+      for (int b = 0; b < bits; ++b) {
+        if (value & (1u << b)) {
+          packed[(bit + b) / 8] |= static_cast<uint8_t>(1u << ((bit + b) % 8));
+        }
+      }
+    }
+    writeInt(*policyOut, stepsToGo);
+    policyOut->write(reinterpret_cast<const char *>(packed.data()),
+                     packed.size());
+    if (!*policyOut) {
+      throw std::runtime_error("Cannot write policy stream");
+    }
+  }
+}
+
+template <class T> char FiniteHorizon<T>::getPolicy(int cell) const {
+  if (model.isFixed(cell) || horizon == 0) {
+    return ' ';
+  }
+  return model.getActionSymbol(actions[cell]);
+}
+
+template <class T> void FiniteHorizon<T>::apply(World &world) const {
+  for (int cell = 0; cell < model.size(); ++cell) {
+    const auto xy = model.cellCoordinates(cell);
+    world.updateUtility(xy.first, xy.second, current[cell]);
+    world.updatePolicy(xy.first, xy.second, getPolicy(cell));
+  }
+}
+
+template <class T>
+std::vector<char> FiniteHorizon<T>::readStage(std::istream &in,
+                                              const TransitionModel &model,
+                                              int stepsToGo) {
+  char magic[sizeof(kMagic)];
+  if (!in.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    throw std::runtime_error("Not a finite horizon policy stream");
+  }
+  const int width = readInt(in);
+  const int height = readInt(in);
+  const int actionCount = readInt(in);
+  const int bits = readInt(in);
+  readInt(in); // horizon
+  const int stages = readInt(in);
+  if (width != model.getWidth() || height != model.getHeight() ||
+      actionCount != model.getActionCount()) {
+    throw std::runtime_error("Policy stream does not match the world");
+  }
+
+  std::vector<uint8_t> packed(
+      (static_cast<size_t>(model.size()) * bits + 7) / 8);
+  for (int stage = 0; stage < stages; ++stage) {
+    const int stored = readInt(in);
+    if (stored != stepsToGo) {
+      in.seekg(packed.size(), std::ios::cur);
+      continue;
+    }
+    if (!in.read(reinterpret_cast<char *>(packed.data()), packed.size())) {
+      throw std::runtime_error("Truncated policy stream");
+    }
+    std::vector<char> policy(model.size(), ' ');
+    for (int cell = 0; cell < model.size(); ++cell) {
+      if (model.isFixed(cell)) {
+        continue;
+      }
+      const size_t bit = static_cast<size_t>(cell) * bits;
+      uint32_t action = 0;
+      for (int b = 0; b < bits; ++b) {
+        if (packed[(bit + b) / 8] & (1u << ((bit + b) % 8))) {
+          action |= 1u << b;
+        }
+      }
+      policy[cell] = model.getActionSymbol(action);
+    }
+    return policy;
+  }
+  throw std::runtime_error("Stage not stored in policy stream");
+}
+
+template class FiniteHorizon<float>;
+template class FiniteHorizon<BFloat16>;
+template class FiniteHorizon<Half>;
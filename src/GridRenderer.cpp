@@ -0,0 +1,159 @@
+#include "GridRenderer.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+const int kCellWidth = 13; // "  |" + 10 characters
+
+void appendRepeated(std::string &out, const char *text, size_t size,
+                    int count) {
+  for (int i = 0; i < count; ++i) {
+    out.append(text, size);
+  }
+}
+
+void appendInt(std::string &out, int value, int width) {
+  char digits[16];
+  int n = 0;
+  const bool negative = value < 0;
+  unsigned magnitude = negative ? 0u - static_cast<unsigned>(value) : value;
+  do {
+    digits[n++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  if (negative) {
+    digits[n++] = '-';
+  }
+  out.append(std::max(width - n, 0), ' ');
+  while (n) {
+    out.push_back(digits[--n]);
+  }
+}
+} // namespace
+
+GridRenderer::GridRenderer(const World &world)
+    : world(world), minX(1), minY(1), maxX(world.getWidth()),
+      maxY(world.getHeight()), interval(1) {}
+
+void GridRenderer::setViewport(int minX, int minY, int maxX, int maxY) {
+  this->minX = std::max(minX, 1);
+  this->minY = std::max(minY, 1);
+  this->maxX = std::min(maxX, world.getWidth());
+  this->maxY = std::min(maxY, world.getHeight());
+}
+
+const std::string &GridRenderer::render() {
+  buffer.clear();
+  const int columns = std::max(maxX - minX + 1, 0);
+  const int rows = std::max(maxY - minY + 1, 0);
+  buffer.reserve((columns * kCellWidth + 2) * 5 * rows + columns * 12 + 1);
+
+  for (int y = maxY; y >= minY; --y) {
+    appendRepeated(buffer, "  +----------", kCellWidth, columns);
+    buffer.append("+\n");
+
+    for (int x = minX; x <= maxX; ++x) {
+      buffer.append("  |         ");
+      buffer.push_back(world.getType(x, y));
+    }
+    buffer.append("|\n");
+
+    appendRepeated(buffer, "  |          ", kCellWidth, columns);
+    buffer.append("|\n");
+
+    for (int x = minX; x <= maxX; ++x) {
+      buffer.append("  | ");
+      buffer.push_back(world.getPolicy(x, y));
+      appendFixed(buffer, world.getValue(x, y), 8);
+    }
+    buffer.append("|\n");
+
+    appendRepeated(buffer, "  +----------", kCellWidth, columns);
+    buffer.append("+\n");
+  }
+
+  for (int x = minX; x <= maxX; ++x) {
+    appendInt(buffer, x, 12);
+  }
+  buffer.push_back('\n');
+  return buffer;
+}
+
+void GridRenderer::print(int fd) {
+  render();
+  std::cout.flush();
+  const char *data = buffer.data();
+  size_t size = buffer.size();
+  while (size > 0) {
+    const ssize_t count = ::write(fd, data, size);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return;
+    }
+    data += count;
+    size -= count;
+  }
+}
+
+void GridRenderer::writeSnapshot(std::ostream &out) const {
+  const int32_t header[4] = {minX, minY, maxX, maxY};
+  out.write("MDPS", 4);
+  out.write(reinterpret_cast<const char *>(header), sizeof(header));
+  for (int y = minY; y <= maxY; ++y) {
+    for (int x = minX; x <= maxX; ++x) {
+      const float utility = world.getValue(x, y);
+      const char cell[2] = {world.getType(x, y), world.getPolicy(x, y)};
+      out.write(reinterpret_cast<const char *>(&utility), sizeof(utility));
+      out.write(cell, sizeof(cell));
+    }
+  }
+}
+
+void GridRenderer::saveSnapshot(const std::string &filename) const {
+  std::ofstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+  writeSnapshot(file);
+}
+
+void GridRenderer::appendFixed(std::string &out, float value, int width) {
+  if (!std::isfinite(value) || std::fabs(value) >= 1e14f) {
+    char text[64];
+    const int n = std::snprintf(text, sizeof(text), "%*.4f", width, value);
+    out.append(text, std::max(n, 0));
+    return;
+  }
+
+  // A float times 10^4 is exact in a double, so rounding it to nearest even
+  // matches the ties of std::fixed output.
+  unsigned long long scaled = static_cast<unsigned long long>(
+      std::nearbyint(std::fabs(double(value)) * 10000.0));
+  char digits[32];
+  int n = 0;
+  for (int i = 0; i < 4; ++i) {
+    digits[n++] = static_cast<char>('0' + scaled % 10);
+    scaled /= 10;
+  }
+  digits[n++] = '.';
+  do {
+    digits[n++] = static_cast<char>('0' + scaled % 10);
+    scaled /= 10;
+  } while (scaled);
+  if (std::signbit(value)) {
+    digits[n++] = '-';
+  }
+  out.append(std::max(width - n, 0), ' ');
+  while (n) {
+    out.push_back(digits[--n]);
+  }
+}
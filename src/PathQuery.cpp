@@ -0,0 +1,122 @@
+#include "PathQuery.hpp"
+#include <stdexcept>
+
+PathQuery::PathQuery(const TransitionModel &model,
+                     const std::vector<char> &policy)
+    : next(model.size(), -1), length(model.size(), -1),
+      ends(model.size(), PathEnd::NoAction), onWalk(model.size(), 0) {
+  if (static_cast<int>(policy.size()) != model.size()) {
+    throw std::runtime_error("Policy does not match the world size");
+  }
+  for (int cell = 0; cell < model.size(); ++cell) {
+    if (model.isTerminal(cell)) {
+      ends[cell] = PathEnd::Terminal;
+      continue;
+    }
+    const int action = model.getActionIndex(policy[cell]);
+    if (action < 0) {
+      continue;
+    }
+    // Ties go to the intended move of a P stencil, otherwise to the first
+    // outcome.
+    const int *targets = model.getTargets(cell, action);
+    int best = -1;
+    float bestWeight = 0.0f;
+    for (int o = 0; o < model.getOutcomeCount(); ++o) {
+      const float weight = model.getWeight(action, o);
+      if (weight > bestWeight ||
+          (best >= 0 && weight == bestWeight &&
+           model.getWeightParameter(action, o) == 0)) {
+        best = o;
+        bestWeight = weight;
+      }
+    }
+    if (best >= 0) {
+      next[cell] = targets[best];
+    }
+  }
+}
+
+Path PathQuery::query(int start) {
+  resolve(start);
+  Path path = {ends[start], {}};
+  path.cells.reserve(length[start] + 1);
+  path.cells.push_back(start);
+  for (int cell = start, step = 0; step < length[start]; ++step) {
+    cell = next[cell];
+    path.cells.push_back(cell);
+  }
+  return path;
+}
+
+std::vector<Path> PathQuery::query(const std::vector<int> &starts) {
+  std::vector<Path> paths;
+  paths.reserve(starts.size());
+  for (int start : starts) {
+    paths.push_back(query(start));
+  }
+  return paths;
+}
+
+int PathQuery::getLength(int start) {
+  resolve(start);
+  return length[start];
+}
+
+PathEnd PathQuery::getEnd(int start) {
+  resolve(start);
+  return ends[start];
+}
+
+const char *PathQuery::getEndName(PathEnd end) {
+  switch (end) {
+  case PathEnd::Terminal:
+    return "terminal";
+  case PathEnd::Cycle:
+    return "cycle";
+  default:
+    return "no_action";
+  }
+}
+
+void PathQuery::resolve(int start) {
+  if (start < 0 || start >= static_cast<int>(next.size())) {
+    throw std::out_of_range("Cell out of range");
+  }
+
+  // Walk until a resolved cell, the end of the path or a cell of this walk.
+  walk.clear();
+  int cell = start;
+  while (length[cell] < 0 && !onWalk[cell]) {
+    if (next[cell] < 0) {
+      length[cell] = 0;
+      break;
+    }
+    onWalk[cell] = 1;
+    walk.push_back(cell);
+    cell = next[cell];
+  }
+
+  if (onWalk[cell]) {
+    // The walk closed a cycle at `cell`. From any cycle cell the path visits
+    // the whole cycle once.
+    size_t first = walk.size();
+    while (walk[--first] != cell) {
+    }
+    const int steps = walk.size() - first - 1;
+    for (size_t i = first; i < walk.size(); ++i) {
+      length[walk[i]] = steps;
+      ends[walk[i]] = PathEnd::Cycle;
+      onWalk[walk[i]] = 0;
+    }
+    walk.resize(first);
+  }
+
+  while (!walk.empty()) {
+    const int previous = walk.back();
+    walk.pop_back();
+    length[previous] = length[next[previous]] + 1;
+    ends[previous] = ends[next[previous]];
+    onWalk[previous] = 0;
+  }
+}
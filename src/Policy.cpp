@@ -1,10 +1,13 @@
 #include "Policy.hpp"
 
-Policy CreatePoliciesForPoint(int x, int y) {
-  return {
-        {'^', {PolicyMove{{{x - 1, y}, {x, y + 1}, {x + 1, y}}}, 0.0f}},
-        {'v', {PolicyMove{{{x - 1, y}, {x, y - 1}, {x + 1, y}}}, 0.0f}},
-        {'<', {PolicyMove{{{x, y - 1}, {x - 1, y}, {x, y + 1}}}, 0.0f}},
-        {'>', {PolicyMove{{{x, y + 1}, {x + 1, y}, {x, y - 1}}}, 0.0f}},
-  };
-}
+Policy CreatePoliciesForPoint(int x, int y, const ActionModel &actions) {
+  Policy policies;
+  for (const auto &action : actions.getActions()) {
+    PolicyMove move;
+    for (const auto &outcome : action.outcomes) {
+      move.push_back({x + outcome.dx, y + outcome.dy});
+    }
+    policies[action.symbol] = {move, 0.0f};
+  }
+  return policies;
+}
\ No newline at end of file
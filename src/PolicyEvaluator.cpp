@@ -0,0 +1,103 @@
+#include "PolicyEvaluator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+PolicyEvaluator::PolicyEvaluator(const TransitionModel &model,
+                                 const World &world)
+    : model(model), actions(model.size(), -1) {
+  for (int cell = 0; cell < model.size(); ++cell) {
+    const auto xy = model.cellCoordinates(cell);
+    actions[cell] = model.getActionIndex(world.getPolicy(xy.first, xy.second));
+  }
+}
+
+std::vector<EvaluationResult>
+PolicyEvaluator::evaluate(const std::vector<int> &starts, long rollouts,
+                          int maxSteps, unsigned threads,
+                          uint64_t seed) const {
+  threads = std::max(threads, 1u);
+  std::vector<std::vector<Accumulator>> totals(
+      threads, std::vector<Accumulator>(starts.size(), Accumulator{0, 0, 0}));
+
+  std::vector<std::thread> workers;
+  for (unsigned t = 1; t < threads; ++t) {
+    workers.emplace_back(&PolicyEvaluator::run, this, std::cref(starts),
+                         rollouts, maxSteps, t, threads, seed,
+                         std::ref(totals[t]));
+  }
+  run(starts, rollouts, maxSteps, 0, threads, seed, totals[0]);
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  std::vector<EvaluationResult> results;
+  results.reserve(starts.size());
+  for (size_t i = 0; i < starts.size(); ++i) {
+    Accumulator total = {0, 0, 0};
+    for (const auto &thread : totals) {
+      total.sum += thread[i].sum;
+      total.squares += thread[i].squares;
+      total.truncated += thread[i].truncated;
+    }
+    EvaluationResult result = {starts[i], rollouts, total.truncated, 0, 0, 0};
+    if (rollouts > 0) {
+      result.mean = total.sum / rollouts;
+    }
+    if (rollouts > 1) {
+      result.variance =
+          std::max(0.0, (total.squares - rollouts * result.mean * result.mean) /
+                            (rollouts - 1));
+      result.halfWidth = 1.96 * std::sqrt(result.variance / rollouts);
+    }
+    results.push_back(result);
+  }
+  return results;
+}
+
+void PolicyEvaluator::run(const std::vector<int> &starts, long rollouts,
+                          int maxSteps, unsigned thread, unsigned threads,
+                          uint64_t seed,
+                          std::vector<Accumulator> &totals) const {
+  std::seed_seq sequence{uint32_t(seed & 0xffffffff), uint32_t(seed >> 32),
+                         uint32_t(thread)};
+  std::mt19937_64 rng(sequence);
+  for (size_t i = 0; i < starts.size(); ++i) {
+    for (long r = thread; r < rollouts; r += threads) {
+      bool truncated = false;
+      const double value = rollout(starts[i], maxSteps, rng, truncated);
+      totals[i].sum += value;
+      totals[i].squares += value * value;
+      totals[i].truncated += truncated;
+    }
+  }
+}
+
+double PolicyEvaluator::rollout(int start, int maxSteps, std::mt19937_64 &rng,
+                                bool &truncated) const {
+  const float gamma = model.getGamma();
+  double value = 0.0;
+  double discount = 1.0;
+  int cell = start;
+  for (int step = 0; step < maxSteps; ++step) {
+    value += discount * model.getReward(cell);
+    if (model.isTerminal(cell)) {
+      return value;
+    }
+    const int action = actions[cell];
+    if (action < 0) {
+      break;
+    }
+    discount *= gamma;
+
+    // Probability missing from the weights ends the rollout with no further
+    // reward.
+    const int next = model.sampleOutcome(cell, action, rng);
+    if (next < 0) {
+      return value;
+    }
+    cell = next;
+  }
+  truncated = true;
+  return value;
+}
@@ -0,0 +1,152 @@
+#include "QTable.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+template <class T>
+DenseQTable<T>::DenseQTable(int cells, int actionCount)
+    : actionCount(actionCount), q(size_t(cells) * actionCount, T(0.0f)),
+      visits(size_t(cells) * actionCount, 0) {}
+
+template <class T> size_t DenseQTable<T>::getMemoryUsage() const {
+  return q.size() * sizeof(T) + visits.size() * sizeof(uint32_t);
+}
+
+template <class T> const int32_t SparseQTable<T>::kEmpty;
+
+template <class T>
+SparseQTable<T>::SparseQTable(int actionCount, size_t maxBytes)
+    : actionCount(actionCount), maxBytes(maxBytes), states(0) {
+  size_t slots = 1024;
+  while (slots > 16 && bytesFor(slots) > maxBytes) {
+    slots /= 2;
+  }
+  if (bytesFor(slots) > maxBytes) {
+    throw std::runtime_error("Q-table memory limit is too small");
+  }
+  rehash(slots);
+}
+
+template <class T> float SparseQTable<T>::getQ(int cell, int action) const {
+  const long slot = find(cell);
+  return slot < 0 ? 0.0f : float(q[slot * actionCount + action]);
+}
+
+template <class T>
+void SparseQTable<T>::setQ(int cell, int action, float value) {
+  q[insert(cell) * actionCount + action] = value;
+}
+
+template <class T>
+uint32_t SparseQTable<T>::getVisits(int cell, int action) const {
+  const long slot = find(cell);
+  return slot < 0 ? 0 : visits[slot * actionCount + action];
+}
+
+template <class T> void SparseQTable<T>::addVisit(int cell, int action) {
+  ++visits[insert(cell) * actionCount + action];
+}
+
+template <class T> size_t SparseQTable<T>::getMemoryUsage() const {
+  return bytesFor(keys.size());
+}
+
+template <class T> bool SparseQTable<T>::getStats(QTableStats &stats) const {
+  const size_t mask = keys.size() - 1;
+  size_t total = 0;
+  size_t longest = 0;
+  for (size_t slot = 0; slot < keys.size(); ++slot) {
+    if (keys[slot] != kEmpty) {
+      const size_t probe = (slot - home(keys[slot])) & mask;
+      total += probe;
+      longest = std::max(longest, probe);
+    }
+  }
+  stats = {states,
+           keys.size(),
+           double(states) / keys.size(),
+           states ? double(total) / states : 0.0,
+           longest,
+           getMemoryUsage()};
+  return true;
+}
+
+template <class T> size_t SparseQTable<T>::bytesFor(size_t slots) const {
+  return slots *
+         (sizeof(int32_t) + actionCount * (sizeof(T) + sizeof(uint32_t)));
+}
+
+template <class T> size_t SparseQTable<T>::home(int cell) const {
+  // Fibonacci hashing spreads neighbouring cells over the table.
+  return (uint64_t(uint32_t(cell)) * 11400714819323198485ull) >> shift;
+}
+
+template <class T> long SparseQTable<T>::find(int cell) const {
+  const size_t mask = keys.size() - 1;
+  for (size_t slot = home(cell);; slot = (slot + 1) & mask) {
+    if (keys[slot] == cell) {
+      return slot;
+    }
+    if (keys[slot] == kEmpty) {
+      return -1;
+    }
+  }
+}
+
+template <class T> size_t SparseQTable<T>::insert(int cell) {
+  const size_t mask = keys.size() - 1;
+  size_t slot = home(cell);
+  for (; keys[slot] != kEmpty; slot = (slot + 1) & mask) {
+    if (keys[slot] == cell) {
+      return slot;
+    }
+  }
+
+  // The old arrays are alive while the new ones fill, both count.
+  if ((states + 1) * 2 > keys.size() &&
+      bytesFor(keys.size()) + bytesFor(keys.size() * 2) <= maxBytes) {
+    rehash(keys.size() * 2);
+    return insert(cell);
+  }
+  if ((states + 1) * 4 > keys.size() * 3) {
+    throw std::runtime_error("Q-table memory limit reached");
+  }
+  keys[slot] = cell;
+  ++states;
+  return slot;
+}
+
+template <class T> void SparseQTable<T>::rehash(size_t slots) {
+  std::vector<int32_t> oldKeys(slots, kEmpty);
+  std::vector<T> oldQ(slots * actionCount, T(0.0f));
+  std::vector<uint32_t> oldVisits(slots * actionCount, 0);
+  oldKeys.swap(keys);
+  oldQ.swap(q);
+  oldVisits.swap(visits);
+
+  shift = 64;
+  for (size_t s = slots; s > 1; s /= 2) {
+    --shift;
+  }
+  const size_t mask = slots - 1;
+  for (size_t old = 0; old < oldKeys.size(); ++old) {
+    if (oldKeys[old] == kEmpty) {
+      continue;
+    }
+    size_t slot = home(oldKeys[old]);
+    while (keys[slot] != kEmpty) {
+      slot = (slot + 1) & mask;
+    }
+    keys[slot] = oldKeys[old];
+    std::copy_n(oldQ.begin() + old * actionCount, actionCount,
+                q.begin() + slot * actionCount);
+    std::copy_n(oldVisits.begin() + old * actionCount, actionCount,
+                visits.begin() + slot * actionCount);
+  }
+}
+
+template class DenseQTable<float>;
+template class DenseQTable<BFloat16>;
+template class DenseQTable<Half>;
+template class SparseQTable<float>;
+template class SparseQTable<BFloat16>;
+template class SparseQTable<Half>;
@@ -0,0 +1,152 @@
+#include "RTDP.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+RTDP::RTDP(const TransitionModel &model, float epsilon, unsigned seed)
+    : model(model), epsilon(epsilon), rng(seed), values(model.size()),
+      solved(model.size(), 0), visited(model.size(), 0),
+      marks(model.size(), 0), generation(0), backups(0) {
+  float max_reward = std::numeric_limits<float>::lowest();
+  float max_terminal = 0.0f;
+  for (int cell = 0; cell < model.size(); ++cell) {
+    if (model.isTerminal(cell)) {
+      max_terminal = std::max(max_terminal, model.getReward(cell));
+    } else if (!model.isFixed(cell)) {
+      max_reward = std::max(max_reward, model.getReward(cell));
+    }
+  }
+
+  // Upper bound of every utility: step rewards never add anything when they
+  // are not positive, otherwise they add at most max_reward / (1 - gamma).
+  float bound = max_terminal;
+  if (max_reward > 0.0f) {
+    if (model.getGamma() >= 1.0f) {
+      throw std::runtime_error(
+          "RTDP needs gamma < 1 or non-positive step rewards");
+    }
+    bound += max_reward / (1.0f - model.getGamma());
+  }
+
+  for (int cell = 0; cell < model.size(); ++cell) {
+    if (model.isFixed(cell)) {
+      values[cell] = model.getInitialValue(cell);
+      solved[cell] = 1;
+    } else {
+      values[cell] = bound;
+    }
+  }
+}
+
+int RTDP::solve(int start, int maxTrials, bool labelled) {
+  const int maxDepth = 10 * model.size();
+  int trials = 0;
+  while (trials < maxTrials && !solved[start]) {
+    ++trials;
+    trajectory.clear();
+    float max_residual = 0.0f;
+
+    int cell = start;
+    while (cell >= 0 && !solved[cell] &&
+           static_cast<int>(trajectory.size()) < maxDepth) {
+      trajectory.push_back(cell);
+      visited[cell] = 1;
+      max_residual = std::max(max_residual, update(cell));
+      int action;
+      backup(cell, &action);
+      // -1 ends the trial on probability missing from the weights.
+      cell = model.sampleOutcome(cell, action, rng);
+    }
+
+    if (!labelled) {
+      if (max_residual < epsilon) {
+        break;
+      }
+      continue;
+    }
+    while (!trajectory.empty()) {
+      const int last = trajectory.back();
+      trajectory.pop_back();
+      if (!checkSolved(last)) {
+        break;
+      }
+    }
+  }
+  return trials;
+}
+
+int RTDP::getVisitedCount() const {
+  return std::count(visited.begin(), visited.end(), 1);
+}
+
+void RTDP::apply(World &world) const {
+  for (int cell = 0; cell < model.size(); ++cell) {
+    if (!visited[cell]) {
+      continue;
+    }
+    const auto xy = model.cellCoordinates(cell);
+    int action;
+    backup(cell, &action);
+    world.updateUtility(xy.first, xy.second, values[cell]);
+    world.updatePolicy(xy.first, xy.second, model.getActionSymbol(action));
+  }
+}
+
+float RTDP::backup(int cell, int *action) const {
+  return model.backup(cell, values.data(), model.getGamma(), action);
+}
+
+float RTDP::update(int cell) {
+  const float newValue = backup(cell);
+  const float residual = std::abs(newValue - values[cell]);
+  values[cell] = newValue;
+  ++backups;
+  return residual;
+}
+
+bool RTDP::checkSolved(int cell) {
+  bool converged = true;
+  ++generation;
+  open.clear();
+  closed.clear();
+  if (!solved[cell]) {
+    open.push_back(cell);
+    marks[cell] = generation;
+  }
+
+  while (!open.empty()) {
+    const int current = open.back();
+    open.pop_back();
+    closed.push_back(current);
+    visited[current] = 1;
+
+    int action;
+    const float newValue = backup(current, &action);
+    if (std::abs(newValue - values[current]) > epsilon) {
+      converged = false;
+      continue;
+    }
+    const int *targets = model.getTargets(current, action);
+    for (int o = 0; o < model.getOutcomeCount(); ++o) {
+      const int target = targets[o];
+      if (model.getWeight(action, o) > 0.0f && !solved[target] &&
+          marks[target] != generation) {
+        marks[target] = generation;
+        open.push_back(target);
+      }
+    }
+  }
+
+  if (converged) {
+    for (int current : closed) {
+      solved[current] = 1;
+    }
+  } else {
+    while (!closed.empty()) {
+      update(closed.back());
+      closed.pop_back();
+    }
+  }
+  return converged;
+}
@@ -0,0 +1,384 @@
+#include "SolverService.hpp"
+#include "AsyncValueIteration.hpp"
+#include "DataLoader.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <thread>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+// Drops blank lines so equal worlds hash equally and edits can be appended.
+std::string normalise(const std::string &source) {
+  std::istringstream input(source);
+  std::string normalised;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (line.find_first_not_of(" \t") == std::string::npos) {
+      continue;
+    }
+    normalised += line;
+    normalised += '\n';
+  }
+  return normalised;
+}
+
+// Applies a RESOLVE body to the normalised base source: "-<line>" removes
+// the first equal line, any other line is appended.
+std::string applyEdits(const std::string &base, const std::string &edits) {
+  std::vector<std::string> lines;
+  std::istringstream input(base);
+  std::string line;
+  while (std::getline(input, line)) {
+    lines.push_back(line);
+  }
+  std::istringstream edit(normalise(edits));
+  while (std::getline(edit, line)) {
+    if (line[0] != '-') {
+      lines.push_back(line);
+      continue;
+    }
+    const auto removed = std::find(lines.begin(), lines.end(), line.substr(1));
+    if (removed == lines.end()) {
+      throw std::runtime_error("No such line to remove: " + line.substr(1));
+    }
+    lines.erase(removed);
+  }
+  std::string source;
+  for (const std::string &kept : lines) {
+    source += kept;
+    source += '\n';
+  }
+  return source;
+}
+
+std::string toHex(uint64_t hash) {
+  std::ostringstream out;
+  out << std::hex << hash;
+  return out.str();
+}
+
+bool readFully(int fd, char *buffer, size_t size) {
+  while (size > 0) {
+    const ssize_t count = ::read(fd, buffer, size);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    buffer += count;
+    size -= count;
+  }
+  return true;
+}
+
+bool writeFully(int fd, const char *buffer, size_t size) {
+  while (size > 0) {
+    const ssize_t count = ::send(fd, buffer, size, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    buffer += count;
+    size -= count;
+  }
+  return true;
+}
+} // namespace
+
+const uint32_t SolverService::kMaxFrameSize;
+
+bool SolverService::readFrame(int fd, std::string &payload) {
+  unsigned char header[4];
+  if (!readFully(fd, reinterpret_cast<char *>(header), sizeof(header))) {
+    return false;
+  }
+  const uint32_t size = uint32_t(header[0]) << 24 | uint32_t(header[1]) << 16 |
+                        uint32_t(header[2]) << 8 | uint32_t(header[3]);
+  if (size > kMaxFrameSize) {
+    return false;
+  }
+  payload.resize(size);
+  return size == 0 || readFully(fd, &payload[0], size);
+}
+
+bool SolverService::writeFrame(int fd, const std::string &payload) {
+  const uint32_t size = payload.size();
+  const char header[4] = {char(size >> 24), char(size >> 16), char(size >> 8),
+                          char(size)};
+  return writeFully(fd, header, sizeof(header)) &&
+         writeFully(fd, payload.data(), payload.size());
+}
+
+SolverService::SolverService(size_t cacheCapacity)
+    : cacheCapacity(std::max<size_t>(cacheCapacity, 1)), clock(0),
+      running(false), listener(-1) {}
+
+uint64_t SolverService::hashSource(const std::string &source) {
+  // 64-bit FNV-1a
+  uint64_t hash = 1469598103934665603ull;
+  for (unsigned char c : source) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::string SolverService::handle(const std::string &request) {
+  const size_t newline = request.find('\n');
+  const std::string header = request.substr(0, newline);
+  const std::string body =
+      newline == std::string::npos ? "" : request.substr(newline + 1);
+  std::istringstream args(header);
+  std::string command;
+  args >> command;
+
+  try {
+    if (command == "SOLVE") {
+      return solve(body, nullptr);
+    } else if (command == "RESOLVE") {
+      std::string hash;
+      if (!(args >> hash)) {
+        throw std::runtime_error("Invalid format for RESOLVE");
+      }
+      const CachedWorld &base = lookup(std::stoull(hash, nullptr, 16));
+      return solve(applyEdits(base.source, body), &base);
+    } else if (command == "POLICY") {
+      return policyQuery(args);
+    } else if (command == "PATH") {
+      return pathQuery(args);
+    } else if (command == "SHUTDOWN") {
+      running = false;
+      return "OK";
+    }
+    return "ERR Unknown command: " + command;
+  } catch (const std::exception &e) {
+    return std::string("ERR ") + e.what();
+  }
+}
+
+std::string SolverService::solve(const std::string &source,
+                                 const CachedWorld *warmStart) {
+  const std::string normalised = normalise(source);
+  const uint64_t hash = hashSource(normalised);
+  // The source is compared too, a colliding hash is solved again and
+  // replaces the cached world.
+  auto it = cache.find(hash);
+  if (it != cache.end() && it->second.source == normalised) {
+    it->second.lastUsed = ++clock;
+    return formatSolution(hash, it->second);
+  }
+
+  DataLoader dataLoader;
+  std::istringstream input(normalised);
+  dataLoader.load(input);
+  World world(dataLoader);
+
+  CachedWorld entry;
+  entry.source = normalised;
+  entry.model.reset(new TransitionModel(world));
+  const TransitionModel &model = *entry.model;
+
+  // Requests are served one at a time, so the solver runs on this thread.
+  AsyncValueIteration<float> solver(model);
+  if (warmStart && warmStart->model->getWidth() == model.getWidth() &&
+      warmStart->model->getHeight() == model.getHeight()) {
+    for (int cell = 0; cell < model.size(); ++cell) {
+      solver.setValue(cell, warmStart->utilities[cell]);
+    }
+  }
+  entry.tiles = solver.solve(0.0001f, 1);
+  entry.utilities.resize(model.size());
+  entry.policy.resize(model.size());
+  for (int cell = 0; cell < model.size(); ++cell) {
+    entry.utilities[cell] = solver.getValue(cell);
+    entry.policy[cell] = solver.getPolicy(cell);
+  }
+  entry.lastUsed = ++clock;
+
+  cache.erase(hash);
+  evict();
+  CachedWorld &stored = cache[hash];
+  stored = std::move(entry);
+  return formatSolution(hash, stored);
+}
+
+std::string SolverService::policyQuery(std::istream &args) {
+  std::string hash;
+  int x, y;
+  if (!(args >> hash >> x >> y)) {
+    throw std::runtime_error("Invalid format for POLICY");
+  }
+  const CachedWorld &entry = lookup(std::stoull(hash, nullptr, 16));
+  const int cell = entry.model->cellIndex(x, y);
+  std::ostringstream out;
+  out << "OK " << (entry.policy[cell] == ' ' ? '.' : entry.policy[cell]) << " "
+      << entry.utilities[cell];
+  return out.str();
+}
+
+std::string SolverService::pathQuery(std::istream &args) {
+  std::string hash;
+  if (!(args >> hash)) {
+    throw std::runtime_error("Invalid format for PATH");
+  }
+  CachedWorld &entry = lookup(std::stoull(hash, nullptr, 16));
+  const TransitionModel &model = *entry.model;
+  std::vector<int> starts;
+  int x, y;
+  while (args >> x >> y) {
+    starts.push_back(model.cellIndex(x, y));
+  }
+  if (starts.empty() || !args.eof()) {
+    throw std::runtime_error("Invalid format for PATH");
+  }
+
+  // Kept with the world, so later requests reuse the resolved paths.
+  if (!entry.paths) {
+    entry.paths.reset(new PathQuery(model, entry.policy));
+  }
+  std::ostringstream out;
+  out << "OK " << starts.size() << "\n";
+  for (int start : starts) {
+    const Path path = entry.paths->query(start);
+    out << PathQuery::getEndName(path.end) << " " << path.cells.size() - 1;
+    for (int cell : path.cells) {
+      const auto xy = model.cellCoordinates(cell);
+      out << " " << xy.first << "," << xy.second;
+    }
+    out << "\n";
+  }
+  return out.str();
+}
+
+SolverService::CachedWorld &SolverService::lookup(uint64_t hash) {
+  auto it = cache.find(hash);
+  if (it == cache.end()) {
+    throw std::runtime_error("Unknown world: " + toHex(hash));
+  }
+  it->second.lastUsed = ++clock;
+  return it->second;
+}
+
+void SolverService::evict() {
+  while (cache.size() >= cacheCapacity) {
+    auto oldest = cache.begin();
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+      if (it->second.lastUsed < oldest->second.lastUsed) {
+        oldest = it;
+      }
+    }
+    cache.erase(oldest);
+  }
+}
+
+std::string SolverService::formatSolution(uint64_t hash,
+                                          const CachedWorld &entry) const {
+  const TransitionModel &model = *entry.model;
+  std::ostringstream out;
+  out << "OK " << toHex(hash) << " " << entry.tiles << "\n";
+  out << "x y type policy utility\n";
+  for (int cell = 0; cell < model.size(); ++cell) {
+    const auto xy = model.cellCoordinates(cell);
+    const char type = model.getType(cell) == ' ' ? '.' : model.getType(cell);
+    const char policy = entry.policy[cell] == ' ' ? '.' : entry.policy[cell];
+    out << xy.first << " " << xy.second << " " << type << " " << policy << " "
+        << entry.utilities[cell] << "\n";
+  }
+  return out.str();
+}
+
+void SolverService::serve(const std::string &socketPath) {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Socket path too long: " + socketPath);
+  }
+  std::strcpy(address.sun_path, socketPath.c_str());
+
+  listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    throw std::runtime_error(std::string("Cannot create socket: ") +
+                             std::strerror(errno));
+  }
+  ::unlink(socketPath.c_str());
+  if (::bind(listener, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) < 0 ||
+      ::listen(listener, 16) < 0) {
+    const std::string error = std::strerror(errno);
+    ::close(listener);
+    throw std::runtime_error("Cannot listen on " + socketPath + ": " + error);
+  }
+
+  running = true;
+  std::string error;
+  while (running) {
+    const int client = ::accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (running) {
+        error = std::strerror(errno);
+        running = false;
+      }
+      break;
+    }
+    std::lock_guard<std::mutex> lock(clientsMutex);
+    clients.insert(client);
+    std::thread(&SolverService::serveClient, this, client).detach();
+  }
+
+  // Wakes up connections waiting for their next frame and lets them finish.
+  {
+    std::unique_lock<std::mutex> lock(clientsMutex);
+    for (int client : clients) {
+      ::shutdown(client, SHUT_RDWR);
+    }
+    clientsDone.wait(lock, [this] { return clients.empty(); });
+  }
+  ::close(listener);
+  ::unlink(socketPath.c_str());
+  if (!error.empty()) {
+    throw std::runtime_error("Cannot accept connection: " + error);
+  }
+}
+
+void SolverService::serveClient(int client) {
+  std::string request;
+  while (running && readFrame(client, request)) {
+    std::string response;
+    {
+      std::lock_guard<std::mutex> lock(requestMutex);
+      response = handle(request);
+    }
+    const bool written = writeFrame(client, response);
+    if (!running) {
+      // SHUTDOWN: stop the accept loop of serve().
+      ::shutdown(listener, SHUT_RDWR);
+    }
+    if (!written) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(clientsMutex);
+  ::close(client);
+  clients.erase(client);
+  if (clients.empty()) {
+    clientsDone.notify_all();
+  }
+}
@@ -0,0 +1,75 @@
+#include "TransitionModel.hpp"
+#include <stdexcept>
+
+TransitionModel::TransitionModel(const World &world)
+    : width(world.getWidth()), height(world.getHeight()),
+      actionCount(world.getActionModel().getActionCount()),
+      outcomeCount(world.getActionModel().getOutcomeCount()),
+      reach(world.getActionModel().getReach()), gamma(world.getGamma()) {
+  types.resize(size());
+  rewards.resize(size());
+  for (int y = 1; y <= height; ++y) {
+    for (int x = 1; x <= width; ++x) {
+      types[cellIndex(x, y)] = world.getType(x, y);
+      rewards[cellIndex(x, y)] = world.getReward(x, y);
+    }
+  }
+
+  // Shorter stencils are padded with zero weight outcomes that stay in the
+  // cell, so every action has outcomeCount entries.
+  const auto &actions = world.getActionModel().getActions();
+  std::vector<std::pair<int, int>> offsets(actionCount * outcomeCount, {0, 0});
+  weights.assign(actionCount * outcomeCount, 0.0f);
+  parameters.assign(actionCount * outcomeCount, -1);
+  for (int a = 0; a < actionCount; ++a) {
+    actionSymbols.push_back(actions[a].symbol);
+    for (size_t o = 0; o < actions[a].outcomes.size(); ++o) {
+      const ActionOutcome &outcome = actions[a].outcomes[o];
+      offsets[a * outcomeCount + o] = {outcome.dx, outcome.dy};
+      weights[a * outcomeCount + o] = outcome.probability;
+      parameters[a * outcomeCount + o] = outcome.parameter;
+    }
+  }
+
+  targets.resize(size() * actionCount * outcomeCount);
+  for (int cell = 0; cell < size(); ++cell) {
+    const int x = cell % width + 1;
+    const int y = cell / width + 1;
+    for (int a = 0; a < actionCount; ++a) {
+      for (int o = 0; o < outcomeCount; ++o) {
+        const int new_x = x + offsets[a * outcomeCount + o].first;
+        const int new_y = y + offsets[a * outcomeCount + o].second;
+        int target = cell;
+        if (new_x >= 1 && new_x <= width && new_y >= 1 && new_y <= height &&
+            types[cellIndex(new_x, new_y)] != 'F') {
+          target = cellIndex(new_x, new_y);
+        }
+        targets[(cell * actionCount + a) * outcomeCount + o] = target;
+      }
+    }
+  }
+}
+
+int TransitionModel::cellIndex(int x, int y) const {
+  if (x < 1 || x > width || y < 1 || y > height) {
+    throw std::out_of_range("Coordinates out of range");
+  }
+  return (y - 1) * width + (x - 1);
+}
+
+std::pair<int, int> TransitionModel::cellCoordinates(int cell) const {
+  return {cell % width + 1, cell / width + 1};
+}
+
+float TransitionModel::getInitialValue(int cell) const {
+  return (types[cell] == 'T' || types[cell] == '*') ? rewards[cell] : 0.0f;
+}
+
+int TransitionModel::getActionIndex(char symbol) const {
+  for (int a = 0; a < actionCount; ++a) {
+    if (actionSymbols[a] == symbol) {
+      return a;
+    }
+  }
+  return -1;
+}
@@ -1,11 +1,24 @@
 #include "World.hpp"
+#include "GridRenderer.hpp"
 #include <chrono>
 #include <cmath>
+#include <fstream>
 #include <iostream>
 #include <limits>
 #include <random>
+#include <stdexcept>
 #include <vector>
 
+namespace {
+template <class T>
+QTable *newQTable(int cells, int actionCount, size_t sparseBytes) {
+  if (sparseBytes > 0) {
+    return new SparseQTable<T>(actionCount, sparseBytes);
+  }
+  return new DenseQTable<T>(cells, actionCount);
+}
+} // namespace
+
 World::World(const DataLoader &dataLoader) {
   auto [w, h] = dataLoader.getWorldSize();
   width = w;
@@ -23,45 +36,72 @@ World::World(const DataLoader &dataLoader) {
   gamma = dataLoader.getGamma();
   reward = dataLoader.getDefaultReward();
   epsilon = dataLoader.getEpsilon();
+  actionModel = dataLoader.getActionModel();
   initializeGrid();
 
-  auto probs = dataLoader.getProbabilities();
+  exploration = Exploration(ExplorationKind::EpsilonGreedy, epsilon);
+  uint64_t timeSeed =
+      std::chrono::high_resolution_clock::now().time_since_epoch().count();
+  std::seed_seq ss{uint32_t(timeSeed & 0xffffffff), uint32_t(timeSeed >> 32)};
+  rng.seed(ss);
+  actionQ.resize(actionModel.getActionCount());
+  actionVisits.resize(actionModel.getActionCount());
+}
+
+void World::useSparseQTable(size_t maxBytes) {
+  sparseBytes = maxBytes;
+  qTable.reset(createQTable());
+}
 
-  probabilities[1] = std::get<0>(probs);
-  probabilities[0] = std::get<1>(probs);
-  probabilities[2] = std::get<2>(probs);
+void World::setQPrecision(Precision precision) {
+  if (precision == Precision::Double) {
+    throw std::runtime_error("Q-tables store float, bf16 or fp16 values");
+  }
+  qPrecision = precision;
+  // The dense table stays unallocated until it is used.
+  qTable.reset(sparseBytes ? createQTable() : nullptr);
+}
+
+QTable &World::getQTable() {
+  // Created on first use, so a sparse table chosen before learning starts
+  // never pays for the dense one.
+  if (!qTable) {
+    qTable.reset(createQTable());
+  }
+  return *qTable;
+}
+
+QTable *World::createQTable() const {
+  const int actions = actionModel.getActionCount();
+  switch (qPrecision) {
+  case Precision::BFloat16:
+    return newQTable<BFloat16>(width * height, actions, sparseBytes);
+  case Precision::Half:
+    return newQTable<Half>(width * height, actions, sparseBytes);
+  default:
+    return newQTable<float>(width * height, actions, sparseBytes);
+  }
+}
 
-  std::cout << probabilities[0] << " " << probabilities[1] << "0.1"
-            << probabilities[2] << std::endl;
+void World::setExploration(const Exploration &exploration) {
+  this->exploration = exploration;
 }
 
 void World::initializeGrid() {
-  grid.resize(height,
-              std::vector<State>(
-                  width, {
-                             0.0f,
-                             ' ',
-                             reward,
-                             ' ',
-                             {{'^', 0}, {'v', 0}, {'<', 0}, {'>', 0}},
-                             {{'^', 0.0}, {'v', 0.0}, {'<', 0.0}, {'>', 0.0}},
-                         }));
+  grid.resize(height, std::vector<State>(width, {
+                                                    0.0f,
+                                                    ' ',
+                                                    reward,
+                                                    ' ',
+                                                }));
 
   for (const auto &ts : terminalStates) {
     grid[ts.y - 1][ts.x - 1] = {ts.reward, 'T', ts.reward, ' '};
   }
 
   for (const auto &ss : specialStates) {
-    grid[ss.y - 1][ss.x - 1] = {
-        ss.reward,
-        '*',
-        ss.reward,
-        ' ',
-        {{'^', 0}, {'v', 0}, {'<', 0}, {'>', 0}},
-        {{'^', 0.0},
-         {'v', 0.0},
-         {'<', 0.0},
-         {'>', 0.0}}}; // Special states can have specific values
+    grid[ss.y - 1][ss.x - 1] = {ss.reward, '*', ss.reward,
+                                ' '}; // Special states can have specific values
   }
 
   for (const auto &fs : forbiddenStates) {
@@ -74,40 +114,8 @@ void World::initializeGrid() {
 }
 
 void World::printWorld() const {
-  for (int y = height - 1; y >= 0; --y) {
-    for (int x = 0; x < width; ++x) {
-      std::cout << "  +----------";
-    }
-    std::cout << "+" << std::endl;
-
-    for (int x = 0; x < width; ++x) {
-      std::cout << "  |" << std::setw(10);
-
-      std::cout << grid[y][x].type;
-    }
-    std::cout << "|" << std::endl;
-
-    for (int x = 0; x < width; ++x) {
-      std::cout << "  |" << std::setw(10) << " ";
-    }
-    std::cout << "|" << std::endl;
-
-    for (int x = 0; x < width; ++x) {
-      std::cout << "  | " << grid[y][x].policy << std::setw(8) << std::fixed
-                << std::setprecision(4) << grid[y][x].utility;
-    }
-    std::cout << "|" << std::endl;
-
-    for (int x = 0; x < width; ++x) {
-      std::cout << "  +----------";
-    }
-    std::cout << "+" << std::endl;
-  }
-
-  for (int x = 1; x <= width; ++x) {
-    std::cout << std::setw(12) << x;
-  }
-  std::cout << std::endl;
+  GridRenderer renderer(*this);
+  renderer.print();
 }
 
 void World::updateUtility(int x, int y, float utility) {
@@ -169,7 +177,7 @@ float World::getReward(int x, int y) const {
 
 void World::addVisit(int x, int y, char action) {
   if (x >= 1 && x <= width && y >= 1 && y <= height) {
-    grid[y - 1][x - 1].visits.at(action)++;
+    getQTable().addVisit((y - 1) * width + (x - 1), getActionIndex(action));
   } else {
     throw std::out_of_range("Coordinates out of range");
   }
@@ -177,7 +185,8 @@ void World::addVisit(int x, int y, char action) {
 
 uint32_t World::getVisits(int x, int y, char action) const {
   if (x >= 1 && x <= width && y >= 1 && y <= height) {
-    return grid[y - 1][x - 1].visits.at(action);
+    const int index = getActionIndex(action);
+    return qTable ? qTable->getVisits((y - 1) * width + (x - 1), index) : 0;
   } else {
     throw std::out_of_range("Coordinates out of range");
   }
@@ -217,69 +226,33 @@ float World::getMaxQValue(int x, int y) {
     return 0.0;
   }
 
-  std::map<char, std::vector<std::array<int, 2>>> actions = {// UP
-                                                             {'^',
-                                                              {
-                                                                  {x - 1, y},
-                                                                  {x, y + 1},
-                                                                  {x + 1, y},
-                                                              }},
-                                                             // DOWN
-                                                             {'v',
-                                                              {
-                                                                  {x - 1, y},
-                                                                  {x, y - 1},
-                                                                  {x + 1, y},
-                                                              }},
-                                                             // LEFT
-                                                             {'<',
-                                                              {
-                                                                  {x, y - 1},
-                                                                  {x - 1, y},
-                                                                  {x, y + 1},
-                                                              }},
-                                                             // RIGHT
-                                                             {
-                                                                 '>',
-                                                                 {
-                                                                     {x, y - 1},
-                                                                     {x + 1, y},
-                                                                     {x, y + 1},
-                                                                 },
-                                                             }};
-
   float max_utility = std::numeric_limits<float>::lowest();
   char max_policy = 'o';
-  for (const auto &[key, action] : actions) {
+  for (const auto &action : actionModel.getActions()) {
     float utility = 0.0;
 
-    // const float probabilities[3] = {0.1, 0.8, 0.1};
-    for (int i = 0; i < 3; ++i) {
-      auto new_x = action[i][0];
-      auto new_y = action[i][1];
+    for (const auto &outcome : action.outcomes) {
+      auto new_x = x + outcome.dx;
+      auto new_y = y + outcome.dy;
 
       try {
         const auto target_policy = getType(new_x, new_y);
         if (target_policy == 'F') {
-          utility += probabilities[i] * getValue(x, y);
+          utility += outcome.probability * getValue(x, y);
 
         } else {
-          utility += probabilities[i] * getValue(new_x, new_y);
+          utility += outcome.probability * getValue(new_x, new_y);
         }
       } catch (const std::out_of_range &e) {
-        utility += probabilities[i] * getValue(x, y);
+        utility += outcome.probability * getValue(x, y);
       }
     }
     utility *= gamma;
 
     if (max_utility < utility) {
-      max_policy = key;
+      max_policy = action.symbol;
       max_utility = utility;
     }
-
-    // std::cout << "For state(" << x << "," << y << ") next state: ("
-    //           << action[1][0] << "," << action[1][1]
-    //           << ") is counted: " << utility << std::endl;
   }
 
   updatePolicy(x, y, max_policy);
@@ -290,7 +263,7 @@ float World::getMaxQValue(int x, int y) {
 float World::getQValue(int x, int y, char action) {
 
   if (x >= 1 && x <= width && y >= 1 && y <= height) {
-    return grid[y - 1][x - 1].q.at(action);
+    return getQTable().getQ((y - 1) * width + (x - 1), getActionIndex(action));
   } else {
     throw std::out_of_range("Coordinates out of range");
   }
@@ -298,35 +271,61 @@ float World::getQValue(int x, int y, char action) {
 
 void World::updateQValue(int x, int y, char action, float value) {
   if (x >= 1 && x <= width && y >= 1 && y <= height) {
-    grid[y - 1][x - 1].q.at(action) = value;
+    getQTable().setQ((y - 1) * width + (x - 1), getActionIndex(action), value);
   } else {
     throw std::out_of_range("Coordinates out of range");
   }
 }
 
 std::pair<int, int> World::getStart() {
-  for (int i = 1; i <= width; ++i) {
-    for (int j = 1; j <= height; ++j) {
-      if (getType(i, j) == 'S') {
-        return {i, j};
-      }
-    }
+  if (startStateSet) {
+    return startState;
   }
   return {-1, -1};
 }
 
-void World::QLearning(int start_x, int start_y, int &x, int& y ) {
+void World::savePolicy(const std::string &filename) const {
+  std::ofstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+  for (int y = height; y >= 1; --y) {
+    for (int x = 1; x <= width; ++x) {
+      const char policy = getPolicy(x, y);
+      file << (policy == ' ' ? '.' : policy);
+    }
+    file << "\n";
+  }
+}
 
-  while (getType(x, y) != 'T') {
-    auto action = getRandomAction(x, y);
+void World::loadPolicy(const std::string &filename) {
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    throw std::runtime_error("Cannot open file: " + filename);
+  }
+  std::string line;
+  for (int y = height; y >= 1; --y) {
+    if (!std::getline(file, line) || static_cast<int>(line.size()) < width) {
+      throw std::runtime_error("Policy does not match the world size");
+    }
+    for (int x = 1; x <= width; ++x) {
+      updatePolicy(x, y, line[x - 1] == '.' ? ' ' : line[x - 1]);
+    }
+  }
+}
+
+bool World::QLearning(int &x, int &y, int maxSteps) {
+  int steps = 0;
+  while (getType(x, y) != 'T' && steps++ < maxSteps) {
+    auto action = chooseAction(x, y);
     // std::cout << "at (" << x << "," << y << ") " << std::endl;
-    auto [new_x, new_y] = execute_action(x, y, action.first);
+    auto [new_x, new_y] = execute_action(x, y, action);
     // std::cout << "looking at (" << new_x << "," << new_y << ")" <<
     // std::endl;
 
-    addVisit(x, y, action.first);
-    float alpha = 1.0 / (getVisits(x, y, action.first));
-    float old_q = getQValue(x, y, action.first);
+    addVisit(x, y, action);
+    float alpha = 1.0 / (getVisits(x, y, action));
+    float old_q = getQValue(x, y, action);
 
     float q_max = 0.0;
 
@@ -339,88 +338,117 @@ void World::QLearning(int start_x, int start_y, int &x, int& y ) {
     float new_q = getReward(x, y) + gamma * q_max;
     float updated_q = old_q + alpha * (new_q - old_q);
 
-    updateQValue(x, y, action.first, updated_q);
+    updateQValue(x, y, action, updated_q);
     q_max = getMaxQValue(x, y);
     updateUtility(x, y, q_max);
 
     x = new_x;
     y = new_y;
   }
+  exploration.nextEpisode();
+  return getType(x, y) == 'T';
 }
 
-std::pair<char, std::vector<std::array<int, 2>>> World::getRandomAction(int x,
-                                                                        int y) {
-  std::map<char, std::vector<std::array<int, 2>>> actions = {// DOWN
-                                                             {'v',
-                                                              {
-                                                                  {x - 1, y},
-                                                                  {x, y - 1},
-                                                                  {x + 1, y},
-                                                              }},
-                                                             // UP
-                                                             {'^',
-                                                              {
-                                                                  {x - 1, y},
-                                                                  {x, y + 1},
-                                                                  {x + 1, y},
-                                                              }},
-                                                             // LEFT
-                                                             {'<',
-                                                              {
-                                                                  {x, y - 1},
-                                                                  {x - 1, y},
-                                                                  {x, y + 1},
-                                                              }},
-                                                             // RIGHT
-                                                             {
-                                                                 '>',
-                                                                 {
-                                                                     {x, y - 1},
-                                                                     {x + 1, y},
-                                                                     {x, y + 1},
-                                                                 },
-                                                             }};
-
-  auto it = actions.begin();
-
-  std::mt19937_64 rng;
-  uint64_t timeSeed =
-      std::chrono::high_resolution_clock::now().time_since_epoch().count();
-  std::seed_seq ss{uint32_t(timeSeed & 0xffffffff), uint32_t(timeSeed >> 32)};
-  rng.seed(ss);
-  std::uniform_real_distribution<double> unif(0, 1);
-  auto random = unif(rng);
-  auto policy = getPolicy(x, y);
-  std::cout << "epsilon: " << epsilon << " random: " << random << std::endl;
-  if (random < epsilon or policy == ' ') {
-    random = unif(rng);
-    if (random < 0.75) {
-      ++it;
+bool World::QLambda(int &x, int &y, float lambda, bool sarsa, int maxSteps) {
+  traces.clear();
+  char action = chooseAction(x, y);
+
+  // A greedy action bumping into a wall can keep its Q-value once the
+  // 1 / visits step drops below float resolution, so episodes are capped.
+  int steps = 0;
+  while (getType(x, y) != 'T' && steps++ < maxSteps) {
+    const std::pair<int, int> next = execute_action(x, y, action);
+    const int new_x = next.first;
+    const int new_y = next.second;
+    addVisit(x, y, action);
+
+    char next_action = ' ';
+    bool greedy = true;
+    float q_next = 0.0;
+    if (getType(new_x, new_y) != 'T') {
+      next_action = chooseAction(new_x, new_y);
+      const float q_best = getQValue(new_x, new_y, getBestQAction(new_x, new_y));
+      const float q_taken = getQValue(new_x, new_y, next_action);
+      greedy = q_taken >= q_best;
+      q_next = sarsa ? q_taken : q_best;
+    } else {
+      q_next = getReward(new_x, new_y);
     }
-    if (random < 0.5) {
-      ++it;
+
+    const float delta =
+        getReward(x, y) + gamma * q_next - getQValue(x, y, action);
+    traces.visit(x, y, action);
+    for (const auto &trace : traces.getTraces()) {
+      const float alpha =
+          1.0 / getVisits(trace.x, trace.y, trace.action);
+      const float q = getQValue(trace.x, trace.y, trace.action);
+      updateQValue(trace.x, trace.y, trace.action,
+                   q + alpha * delta * trace.eligibility);
+
+      const char best = getBestQAction(trace.x, trace.y);
+      updatePolicy(trace.x, trace.y, best);
+      updateUtility(trace.x, trace.y, getQValue(trace.x, trace.y, best));
     }
-    if (random < 0.25) {
-      ++it;
+
+    // Watkins' variant only follows the greedy policy, an exploratory step
+    // breaks the chain of credit.
+    if (!sarsa && !greedy) {
+      traces.clear();
+    } else {
+      traces.decay(gamma * lambda);
     }
-    return *it;
+
+    x = new_x;
+    y = new_y;
+    action = next_action;
   }
-  return {policy, actions[policy]};
+  exploration.nextEpisode();
+  return getType(x, y) == 'T';
+}
+
+char World::getBestQAction(int x, int y) {
+  const QTable &table = getQTable();
+  const int cell = (y - 1) * width + (x - 1);
+  int best = 0;
+  for (int a = 1; a < actionModel.getActionCount(); ++a) {
+    if (table.getQ(cell, a) > table.getQ(cell, best)) {
+      best = a;
+    }
+  }
+  return actionModel.getActions()[best].symbol;
+}
+
+char World::chooseAction(int x, int y) {
+  const auto &actions = actionModel.getActions();
+  const QTable &table = getQTable();
+  const int cell = (y - 1) * width + (x - 1);
+  for (size_t a = 0; a < actions.size(); ++a) {
+    actionQ[a] = table.getQ(cell, a);
+    actionVisits[a] = table.getVisits(cell, a);
+  }
+  const int greedy = actionModel.getIndex(getPolicy(x, y));
+  return actions[exploration.select(actionQ.data(), actionVisits.data(),
+                                    actions.size(), greedy, rng)]
+      .symbol;
+}
+
+int World::getActionIndex(char action) const {
+  const int index = actionModel.getIndex(action);
+  if (index < 0) {
+    throw std::out_of_range(std::string("Unknown action: ") + action);
+  }
+  return index;
 }
 
 std::pair<int, int> World::execute_action(int start_x, int start_y,
                                           char action) {
-  auto x = start_x;
-  auto y = start_y;
-  if (action == '^') {
-    y += 1;
-  } else if (action == 'v') {
-    y -= 1;
-  } else if (action == '<') {
-    x -= 1;
-  } else if (action == '>') {
-    x += 1;
+  const int index = actionModel.getIndex(action);
+  if (index < 0) {
+    return {start_x, start_y};
   }
+  const auto move = actionModel.getMove(index);
+  auto x = start_x + move.first;
+  auto y = start_y + move.second;
   try {
     if (getType(x, y) == 'F') {
       return {start_x, start_y};
@@ -1,4 +1,6 @@
+#include "AsyncValueIteration.hpp"
 #include "DataLoader.hpp"
+#include "TransitionModel.hpp"
 #include "World.hpp"
 #include "gnuplot-iostream.h"
 #include <iostream>
@@ -10,12 +12,49 @@ struct StateData {
   std::vector<double> utilities;
 };
 
+template <class T> void solveAsync(World &world, unsigned threads) {
+  TransitionModel model(world);
+  AsyncValueIteration<T> solver(model);
+  const long tiles = solver.solve(0.0001f, threads);
+  std::cout << "Processed " << tiles << " tiles on " << threads
+            << " threads, " << solver.getSteals() << " stolen" << std::endl;
+  solver.apply(world);
+}
+
 int main(int argc, char *argv[]) {
 
   if (argc == 1) {
     std::cerr << "Add argument data path!" << std::endl;
     return -1;
   }
+  std::string policyFile;
+  unsigned asyncThreads = 0;
+  Precision precision = Precision::Float;
+  try {
+    for (int i = 2; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (arg == "--save-policy" && i + 1 < argc) {
+        policyFile = argv[++i];
+      } else if (arg == "--async" && i + 1 < argc) {
+        asyncThreads = std::stoul(argv[++i]);
+      } else if (arg == "--precision" && i + 1 < argc) {
+        precision = parsePrecision(argv[++i]);
+      } else {
+        std::cerr << "Unknown argument: " << arg << std::endl;
+        return -1;
+      }
+    }
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  if (precision != Precision::Float &&
+      (asyncThreads == 0 || precision == Precision::Double)) {
+    std::cerr << "--precision needs --async and one of float, bf16, fp16"
+              << std::endl;
+    return -1;
+  }
+
   DataLoader dataLoader;
   try {
     dataLoader.load(argv[1]); // Replace with your actual data file path
@@ -25,15 +64,36 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  const auto probabilities = dataLoader.getProbabilities();
   const auto gamma = dataLoader.getGamma();
   const auto epsilon = dataLoader.getEpsilon();
-  std::cout << "Probabilities: " << std::get<0>(probabilities) << " "
-            << std::get<1>(probabilities) << " " << std::get<2>(probabilities)
-            << std::endl;
+  if (dataLoader.hasProbabilities()) {
+    const auto probabilities = dataLoader.getProbabilities();
+    std::cout << "Probabilities: " << std::get<0>(probabilities) << " "
+              << std::get<1>(probabilities) << " "
+              << std::get<2>(probabilities) << std::endl;
+  }
   World world(dataLoader);
 
   world.printWorld();
+
+  if (asyncThreads > 0) {
+    switch (precision) {
+    case Precision::BFloat16:
+      solveAsync<BFloat16>(world, asyncThreads);
+      break;
+    case Precision::Half:
+      solveAsync<Half>(world, asyncThreads);
+      break;
+    default:
+      solveAsync<float>(world, asyncThreads);
+    }
+    world.printWorld();
+    if (!policyFile.empty()) {
+      world.savePolicy(policyFile);
+    }
+    return 0;
+  }
+
   Gnuplot gp;
   // Store the values for each position over all iterations
   std::vector<std::vector<std::vector<double>>> allValues(
@@ -47,7 +107,7 @@ int main(int argc, char *argv[]) {
 
     for (int x = 0; x < world.getWidth(); ++x) {
       for (int y = 0; y < world.getHeight(); ++y) {
-        allValues[x][y].push_back(world.getValue(x, y));
+        allValues[x][y].push_back(world.getValue(x + 1, y + 1));
       }
     }
   }
@@ -81,6 +141,9 @@ int main(int argc, char *argv[]) {
     }
   }
   world.printWorld();
+  if (!policyFile.empty()) {
+    world.savePolicy(policyFile);
+  }
 
   //   world.valueIteration(gamma, 0.0001);
 
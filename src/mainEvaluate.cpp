@@ -0,0 +1,87 @@
+#include "DataLoader.hpp"
+#include "PolicyEvaluator.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+int main(int argc, char *argv[]) {
+
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <data_file> <policy_file> [--rollouts N] [--threads T]"
+              << " [--max-steps M] [--seed S] [--all]" << std::endl;
+    return -1;
+  }
+  long rollouts = 10000;
+  unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+  int maxSteps = 10000;
+  uint64_t seed = 0;
+  bool allCells = false;
+  for (int i = 3; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--rollouts" && i + 1 < argc) {
+      rollouts = std::stol(argv[++i]);
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::max(std::stoul(argv[++i]), 1ul);
+    } else if (arg == "--max-steps" && i + 1 < argc) {
+      maxSteps = std::stoi(argv[++i]);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      seed = std::stoull(argv[++i]);
+    } else if (arg == "--all") {
+      allCells = true;
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return -1;
+    }
+  }
+
+  DataLoader dataLoader;
+  try {
+    dataLoader.load(argv[1]);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  World world(dataLoader);
+  try {
+    world.loadPolicy(argv[2]);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  TransitionModel model(world);
+
+  std::vector<int> starts;
+  if (allCells) {
+    for (int cell = 0; cell < model.size(); ++cell) {
+      if (model.getType(cell) != 'F') {
+        starts.push_back(cell);
+      }
+    }
+  } else {
+    const auto start = dataLoader.getStartState();
+    starts.push_back(model.cellIndex(start.first, start.second));
+  }
+
+  PolicyEvaluator evaluator(model, world);
+  const auto results =
+      evaluator.evaluate(starts, rollouts, maxSteps, threads, seed);
+
+  std::cout << rollouts << " rollouts per cell on " << threads << " threads"
+            << std::endl;
+  std::cout << "   x   y        mean    variance      ci95  truncated"
+            << std::endl;
+  for (const auto &result : results) {
+    const auto xy = model.cellCoordinates(result.cell);
+    std::cout << std::setw(4) << xy.first << std::setw(4) << xy.second
+              << std::fixed << std::setprecision(4) << std::setw(12)
+              << result.mean << std::setw(12) << result.variance
+              << std::setw(10) << result.halfWidth << std::setw(11)
+              << result.truncated << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,82 @@
+#include "DataLoader.hpp"
+#include "FiniteHorizon.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+template <class T>
+void solveFiniteHorizon(World &world, int horizon,
+                        const std::string &policyFile, int keepStages) {
+  TransitionModel model(world);
+  FiniteHorizon<T> solver(model, horizon);
+  if (policyFile.empty()) {
+    solver.solve();
+  } else {
+    std::ofstream out(policyFile, std::ios::binary);
+    if (!out.is_open()) {
+      throw std::runtime_error("Cannot open file: " + policyFile);
+    }
+    solver.solve(&out, keepStages);
+  }
+  solver.apply(world);
+}
+
+int main(int argc, char *argv[]) {
+
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <data_file> <horizon> [policy_file] [--keep K]"
+              << " [--precision float|bf16|fp16]" << std::endl;
+    return -1;
+  }
+  const int horizon = std::stoi(argv[2]);
+  std::string policyFile;
+  int keepStages = -1;
+  std::string precision = "float";
+  for (int i = 3; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--keep" && i + 1 < argc) {
+      keepStages = std::stoi(argv[++i]);
+    } else if (arg == "--precision" && i + 1 < argc) {
+      precision = argv[++i];
+    } else {
+      policyFile = arg;
+    }
+  }
+
+  DataLoader dataLoader;
+  try {
+    dataLoader.load(argv[1]);
+    dataLoader.printData();
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  World world(dataLoader);
+  try {
+    switch (parsePrecision(precision)) {
+    case Precision::Float:
+      solveFiniteHorizon<float>(world, horizon, policyFile, keepStages);
+      break;
+    case Precision::BFloat16:
+      solveFiniteHorizon<BFloat16>(world, horizon, policyFile, keepStages);
+      break;
+    case Precision::Half:
+      solveFiniteHorizon<Half>(world, horizon, policyFile, keepStages);
+      break;
+    default:
+      throw std::runtime_error("Unsupported precision: " + precision);
+    }
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "========================[H = " << horizon
+            << "]========================" << std::endl;
+  world.printWorld();
+  return 0;
+}
@@ -1,6 +1,9 @@
 #include "DataLoader.hpp"
+#include "GridRenderer.hpp"
 #include "World.hpp"
 #include "gnuplot-iostream.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <limits>
 
@@ -16,6 +19,61 @@ int main(int argc, char *argv[]) {
     std::cerr << "Add argument data path!" << std::endl;
     return -1;
   }
+  int episodes = 1500;
+  float lambda = 0.0f;
+  bool sarsa = false;
+  std::string policyFile;
+  int renderEvery = 1;
+  int viewport[4] = {1, 1, std::numeric_limits<int>::max(),
+                     std::numeric_limits<int>::max()};
+  std::string snapshotPrefix;
+  std::string explore = "eps";
+  float epsilonDecay = 0.995f;
+  float epsilonMin = 0.01f;
+  float ucbConstant = std::sqrt(2.0f);
+  float bonus = 0.1f;
+  long sparseMiB = 0;
+  std::string precision = "float";
+  int maxSteps = 10000;
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--episodes" && i + 1 < argc) {
+      episodes = std::stoi(argv[++i]);
+    } else if (arg == "--lambda" && i + 1 < argc) {
+      lambda = std::stof(argv[++i]);
+    } else if (arg == "--sarsa") {
+      sarsa = true;
+    } else if (arg == "--save-policy" && i + 1 < argc) {
+      policyFile = argv[++i];
+    } else if (arg == "--render-every" && i + 1 < argc) {
+      renderEvery = std::stoi(argv[++i]);
+    } else if (arg == "--viewport" && i + 4 < argc) {
+      for (int k = 0; k < 4; ++k) {
+        viewport[k] = std::stoi(argv[++i]);
+      }
+    } else if (arg == "--snapshot" && i + 1 < argc) {
+      snapshotPrefix = argv[++i];
+    } else if (arg == "--explore" && i + 1 < argc) {
+      explore = argv[++i];
+    } else if (arg == "--epsilon-decay" && i + 2 < argc) {
+      epsilonDecay = std::stof(argv[++i]);
+      epsilonMin = std::stof(argv[++i]);
+    } else if (arg == "--ucb-c" && i + 1 < argc) {
+      ucbConstant = std::stof(argv[++i]);
+    } else if (arg == "--bonus" && i + 1 < argc) {
+      bonus = std::stof(argv[++i]);
+    } else if (arg == "--sparse-q" && i + 1 < argc) {
+      sparseMiB = std::stol(argv[++i]);
+    } else if (arg == "--precision" && i + 1 < argc) {
+      precision = argv[++i];
+    } else if (arg == "--max-steps" && i + 1 < argc) {
+      maxSteps = std::stoi(argv[++i]);
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return -1;
+    }
+  }
+
   DataLoader dataLoader;
   try {
     dataLoader.load(argv[1]); // Replace with your actual data file path
@@ -25,34 +83,89 @@ int main(int argc, char *argv[]) {
     return 1;
   }
   std::srand(std::time(nullptr));
-  const auto probabilities = dataLoader.getProbabilities();
   const auto gamma = dataLoader.getGamma();
   const auto epsilon = dataLoader.getEpsilon();
 
   World world(dataLoader);
+  try {
+    Exploration exploration(parseExplorationKind(explore), epsilon);
+    exploration.setDecay(epsilonDecay, epsilonMin);
+    exploration.setUCBConstant(ucbConstant);
+    exploration.setBonus(bonus);
+    world.setExploration(exploration);
+    world.setQPrecision(parsePrecision(precision));
+    if (sparseMiB > 0) {
+      world.useSparseQTable(size_t(sparseMiB) << 20);
+    }
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  GridRenderer renderer(world);
+  renderer.setViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  renderer.setInterval(renderEvery);
 
-  world.printWorld();
+  renderer.print();
 
   Gnuplot gp;
-  std::vector<std::vector<std::vector<double>>> allValues(
-      world.getWidth(), std::vector<std::vector<double>>(world.getHeight()));
-  for (int i = 0; i < 1500; ++i) {
-    std::cout << "========================[V(" << i+1
-              << ")]========================" << std::endl;
+  // Value history of the viewport cells, taken on the rendered episodes only
+  // so it stays small on large worlds.
+  const int columns = std::max(renderer.getMaxX() - renderer.getMinX() + 1, 0);
+  const int rows = std::max(renderer.getMaxY() - renderer.getMinY() + 1, 0);
+  std::vector<int> historyEpisodes;
+  std::vector<std::vector<float>> history(size_t(columns) * rows);
+  int cutEpisodes = 0;
+  for (int i = 0; i < episodes; ++i) {
     auto [start_x, start_y] = world.getStart();
     int x = start_x;
     int y = start_y;
-    std::cout << "Iteration " << i << std::endl;
-    world.QLearning(start_x, start_y, x, y);
+    try {
+      const bool finished = lambda > 0.0f || sarsa
+                                ? world.QLambda(x, y, lambda, sarsa, maxSteps)
+                                : world.QLearning(x, y, maxSteps);
+      if (!finished) {
+        ++cutEpisodes;
+      }
+    } catch (const std::runtime_error &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
 
-    world.printWorld();
-    for (int x = 0; x < world.getWidth(); ++x) {
-      for (int y = 0; y < world.getHeight(); ++y) {
-        allValues[x][y].push_back(world.getValue(x, y));
+    if (renderer.shouldRender(i + 1)) {
+      if (!snapshotPrefix.empty()) {
+        renderer.saveSnapshot(snapshotPrefix + std::to_string(i + 1) + ".bin");
+      } else {
+        std::cout << "========================[V(" << i + 1
+                  << ")]========================\n";
+        renderer.print();
+      }
+      historyEpisodes.push_back(i + 1);
+      for (int x = 0; x < columns; ++x) {
+        for (int y = 0; y < rows; ++y) {
+          history[x * rows + y].push_back(world.getValue(
+              renderer.getMinX() + x, renderer.getMinY() + y));
+        }
       }
     }
   }
 
+  if (cutEpisodes > 0) {
+    std::cout << cutEpisodes << " of " << episodes << " episodes cut after "
+              << maxSteps << " steps" << std::endl;
+  }
+  QTableStats stats;
+  if (world.getSparseQTable() && world.getSparseQTable()->getStats(stats)) {
+    std::cout << "Sparse Q-table: " << stats.states << " states in "
+              << stats.capacity << " slots (" << stats.occupancy * 100
+              << "% full), probe length avg " << stats.averageProbe
+              << " max " << stats.maxProbe << ", " << stats.bytes
+              << " bytes" << std::endl;
+  }
+
+  if (!policyFile.empty()) {
+    world.savePolicy(policyFile);
+  }
+
   // Plot the collected data
   gp << "set title 'Value Evolution Over Iterations'\n";
   gp << "set xlabel 'Iteration'\n";
@@ -62,24 +175,23 @@ int main(int argc, char *argv[]) {
   gp << "plot ";
 
   bool first = true;
-  for (int x = 0; x < world.getWidth(); ++x) {
-    for (int y = 0; y < world.getHeight(); ++y) {
+  for (int x = 0; x < columns; ++x) {
+    for (int y = 0; y < rows; ++y) {
       if (!first) {
         gp << ", ";
       }
       first = false;
-      gp << "'-' with lines title 'Value (" << x << "," << y << ")'";
+      gp << "'-' with lines title 'Value (" << renderer.getMinX() + x - 1
+         << "," << renderer.getMinY() + y - 1 << ")'";
     }
   }
   gp << "\n";
 
-  for (int x = 0; x < world.getWidth(); ++x) {
-    for (int y = 0; y < world.getHeight(); ++y) {
-      for (size_t iter = 0; iter < allValues[x][y].size(); ++iter) {
-        gp << iter << " " << allValues[x][y][iter] << "\n";
-      }
-      gp << "e\n";
+  for (const auto &values : history) {
+    for (size_t k = 0; k < values.size(); ++k) {
+      gp << historyEpisodes[k] << " " << values[k] << "\n";
     }
+    gp << "e\n";
   }
 
   return 0;
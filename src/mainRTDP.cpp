@@ -0,0 +1,63 @@
+#include "DataLoader.hpp"
+#include "RTDP.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[]) {
+
+  if (argc == 1) {
+    std::cerr << "Usage: " << argv[0]
+              << " <data_file> [--plain] [--trials N] [--seed S]" << std::endl;
+    return -1;
+  }
+  bool labelled = true;
+  int maxTrials = 100000;
+  unsigned seed = 0;
+  for (int i = 2; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--plain") {
+      labelled = false;
+    } else if (arg == "--trials" && i + 1 < argc) {
+      maxTrials = std::stoi(argv[++i]);
+    } else if (arg == "--seed" && i + 1 < argc) {
+      seed = std::stoul(argv[++i]);
+    } else {
+      std::cerr << "Unknown argument: " << arg << std::endl;
+      return -1;
+    }
+  }
+
+  DataLoader dataLoader;
+  try {
+    dataLoader.load(argv[1]);
+    dataLoader.printData();
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  World world(dataLoader);
+  TransitionModel model(world);
+  const auto start = dataLoader.getStartState();
+  const int startCell = model.cellIndex(start.first, start.second);
+
+  try {
+    RTDP rtdp(model, 0.0001f, seed);
+    const int trials = rtdp.solve(startCell, maxTrials, labelled);
+    std::cout << (labelled ? "LRTDP" : "RTDP") << ": " << trials
+              << " trials, " << rtdp.getBackups() << " backups, "
+              << rtdp.getVisitedCount() << "/" << model.size()
+              << " cells visited, start "
+              << (rtdp.isSolved(startCell) ? "solved" : "not solved")
+              << ", V(start) " << rtdp.getValue(startCell) << std::endl;
+    rtdp.apply(world);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  world.printWorld();
+  return 0;
+}
@@ -0,0 +1,22 @@
+#include "SolverService.hpp"
+#include <iostream>
+#include <string>
+
+int main(int argc, char *argv[]) {
+
+  if (argc == 1) {
+    std::cerr << "Usage: " << argv[0] << " <socket_path> [cache_size]"
+              << std::endl;
+    return -1;
+  }
+  try {
+    const size_t cacheSize = argc > 2 ? std::stoul(argv[2]) : 64;
+    SolverService service(cacheSize);
+    std::cout << "Listening on " << argv[1] << std::endl;
+    service.serve(argv[1]);
+  } catch (const std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
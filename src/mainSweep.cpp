@@ -0,0 +1,90 @@
+#include "BatchSolver.hpp"
+#include "DataLoader.hpp"
+#include "Precision.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <iostream>
+
+template <class T>
+int runSweep(const TransitionModel &model,
+             const std::vector<SweepScenario> &scenarios,
+             const std::pair<int, int> &start, const std::string &prefix) {
+  BatchSolver<T> solver(model, scenarios);
+  const int sweeps = solver.solve(0.0001f, 100000);
+  std::cout << "Solved " << solver.getScenarioCount() << " scenarios in "
+            << sweeps << " sweeps" << std::endl;
+
+  const int startCell = model.cellIndex(start.first, start.second);
+  for (int s = 0; s < solver.getScenarioCount(); ++s) {
+    const SweepScenario &scenario = solver.getScenario(s);
+    std::cout << "  [" << s << "] G " << scenario.gamma << " R "
+              << scenario.reward;
+    if (scenario.hasProbabilities) {
+      std::cout << " P " << scenario.p1 << " " << scenario.p2 << " "
+                << scenario.p3;
+    }
+    std::cout << ": iterations "
+              << solver.getIterations(s) << ", V(start) "
+              << solver.getValue(s, startCell) << std::endl;
+  }
+
+  try {
+    solver.writeTables(prefix);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+
+  std::vector<std::string> args;
+  Precision precision = Precision::Float;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const std::string arg = argv[i];
+      if (arg == "--precision" && i + 1 < argc) {
+        precision = parsePrecision(argv[++i]);
+      } else {
+        args.push_back(arg);
+      }
+    }
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  if (args.size() < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <data_file> <sweep_file> [output_prefix]"
+              << " [--precision float|double|bf16|fp16]" << std::endl;
+    return -1;
+  }
+  const std::string prefix = args.size() > 2 ? args[2] : "sweep_";
+
+  DataLoader dataLoader;
+  std::vector<SweepScenario> scenarios;
+  try {
+    dataLoader.load(args[0]);
+    dataLoader.printData();
+    scenarios = loadSweepScenarios(args[1], dataLoader);
+  } catch (const std::runtime_error &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  World world(dataLoader);
+  TransitionModel model(world);
+  const auto start = dataLoader.getStartState();
+  switch (precision) {
+  case Precision::Double:
+    return runSweep<double>(model, scenarios, start, prefix);
+  case Precision::BFloat16:
+    return runSweep<BFloat16>(model, scenarios, start, prefix);
+  case Precision::Half:
+    return runSweep<Half>(model, scenarios, start, prefix);
+  default:
+    return runSweep<float>(model, scenarios, start, prefix);
+  }
+}
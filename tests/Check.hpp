@@ -0,0 +1,34 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <iostream>
+
+// Minimal assertions for the test executables, which return
+// checkFailures() from main so ctest sees the failures.
+inline int &checkFailures() {
+  static int failures = 0;
+  return failures;
+}
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition        \
+                << ") failed" << std::endl;                                    \
+      ++checkFailures();                                                       \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQUAL(actual, expected)                                          \
+  do {                                                                         \
+    const auto &checkActual = (actual);                                        \
+    const auto &checkExpected = (expected);                                    \
+    if (!(checkActual == checkExpected)) {                                     \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": " #actual " is \""        \
+                << checkActual << "\", expected \"" << checkExpected << "\""   \
+                << std::endl;                                                  \
+      ++checkFailures();                                                       \
+    }                                                                          \
+  } while (0)
+
+#endif // CHECK_HPP
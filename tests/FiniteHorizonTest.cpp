@@ -0,0 +1,96 @@
+#include "Check.hpp"
+#include "DataLoader.hpp"
+#include "FiniteHorizon.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+World loadWorld(const std::string &source) {
+  DataLoader dataLoader;
+  std::istringstream input(source);
+  dataLoader.load(input);
+  return World(dataLoader);
+}
+
+std::vector<char> finalPolicy(const TransitionModel &model, int horizon) {
+  FiniteHorizon<float> solver(model, horizon);
+  solver.solve();
+  std::vector<char> policy(model.size());
+  for (int cell = 0; cell < model.size(); ++cell) {
+    policy[cell] = solver.getPolicy(cell);
+  }
+  return policy;
+}
+
+bool throws(const std::string &stream, const TransitionModel &model,
+            int stepsToGo) {
+  std::istringstream in(stream);
+  try {
+    FiniteHorizon<float>::readStage(in, model, stepsToGo);
+  } catch (const std::runtime_error &) {
+    return true;
+  }
+  return false;
+}
+
+// Every stored stage read back equals the policy of a run with that many
+// steps to go.
+void checkRoundTrip(const std::string &source, int horizon, int keep) {
+  const World world = loadWorld(source);
+  const TransitionModel model(world);
+  std::ostringstream out;
+  FiniteHorizon<float> solver(model, horizon);
+  solver.solve(&out, keep);
+  const std::string stream = out.str();
+
+  const int stored = keep < 0 ? horizon : std::min(keep, horizon);
+  const size_t stageBytes =
+      (size_t(model.size()) * FiniteHorizon<float>::bitsPerAction(
+                                  model.getActionCount()) +
+       7) / 8;
+  CHECK_EQUAL(stream.size(), 7 * 4 + stored * (4 + stageBytes));
+
+  for (int stepsToGo = 1; stepsToGo <= horizon; ++stepsToGo) {
+    if (stepsToGo <= horizon - stored) {
+      CHECK(throws(stream, model, stepsToGo));
+      continue;
+    }
+    std::istringstream in(stream);
+    CHECK(FiniteHorizon<float>::readStage(in, model, stepsToGo) ==
+          finalPolicy(model, stepsToGo));
+  }
+  CHECK(throws(stream, model, horizon + 1));
+  CHECK(throws(stream.substr(0, stream.size() - 1), model, horizon));
+}
+
+} // namespace
+
+int main() {
+  const std::string grid = "W 7 5\nS 1 1\nR -0.04\nG 0.95\nP 0.8 0.1 0.1\n"
+                           "T 7 5 1\nT 7 4 -1\nF 3 3\nF 4 2\nB 2 4 -0.5\n";
+  checkRoundTrip(grid, 12, -1);             // 2 bits per action
+  checkRoundTrip(grid, 12, 5);              // only the last 5 stages
+  checkRoundTrip(grid + "M 8\n", 12, -1);   // 3 bits, across byte borders
+  checkRoundTrip(grid + "M 0\nA o 1 0 0\nA > 0.9 1 0\nA ^ 0.9 0 1\n"
+                        "A 9 0.5 1 1 0.5 0 0\nA < 1 -1 0\n",
+                 9, -1);                    // 5 actions in 3 bits
+  checkRoundTrip(grid, 0, -1);
+
+  // A stream of another world is rejected.
+  const World world = loadWorld(grid);
+  const TransitionModel model(world);
+  std::ostringstream out;
+  FiniteHorizon<float> solver(model, 3);
+  solver.solve(&out);
+  const World other = loadWorld(grid + "M 8\n");
+  const TransitionModel otherModel(other);
+  CHECK(throws(out.str(), otherModel, 1));
+  CHECK(throws("FHP0" + out.str().substr(4), model, 1));
+  return checkFailures();
+}
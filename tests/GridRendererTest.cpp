@@ -0,0 +1,60 @@
+#include "Check.hpp"
+#include "GridRenderer.hpp"
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::string expected(float value, int width) {
+  std::ostringstream out;
+  out << std::setw(width) << std::fixed << std::setprecision(4) << value;
+  return out.str();
+}
+
+std::string actual(float value, int width) {
+  std::string out;
+  GridRenderer::appendFixed(out, value, width);
+  return out;
+}
+
+} // namespace
+
+int main() {
+  // Exact ties of the fifth decimal round to even like iostream does.
+  const float ties[] = {0.28125f, 0.03125f, 0.09375f, 0.15625f, 0.40625f,
+                        1.21875f, 2.5f / 1024.0f, 12.34375f, 0.00005f};
+  for (float tie : ties) {
+    CHECK_EQUAL(actual(tie, 8), expected(tie, 8));
+    CHECK_EQUAL(actual(-tie, 8), expected(-tie, 8));
+  }
+  for (int k = 0; k < 1 << 12; ++k) {
+    const float tie = (2 * k + 1) / 32.0f;
+    CHECK_EQUAL(actual(tie, 8), expected(tie, 8));
+  }
+
+  const float special[] = {0.0f,
+                           -0.0f,
+                           -0.00004f,
+                           1e13f,
+                           1e20f,
+                           std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           std::numeric_limits<float>::quiet_NaN()};
+  for (float value : special) {
+    CHECK_EQUAL(actual(value, 8), expected(value, 8));
+  }
+  CHECK_EQUAL(actual(0.5f, 2), expected(0.5f, 2));
+  CHECK_EQUAL(actual(-123.5f, 12), expected(-123.5f, 12));
+
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> unif(-1000.0f, 1000.0f);
+  for (int i = 0; i < 100000; ++i) {
+    const float value = unif(rng);
+    CHECK_EQUAL(actual(value, 8), expected(value, 8));
+  }
+  return checkFailures();
+}
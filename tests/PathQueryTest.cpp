@@ -0,0 +1,135 @@
+#include "Check.hpp"
+#include "DataLoader.hpp"
+#include "PathQuery.hpp"
+#include "TransitionModel.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+World loadWorld(const std::string &source) {
+  DataLoader dataLoader;
+  std::istringstream input(source);
+  dataLoader.load(input);
+  return World(dataLoader);
+}
+
+// Follows the intended moves step by step, without any memo.
+Path walk(const TransitionModel &model, const std::vector<char> &policy,
+          int start) {
+  Path path = {PathEnd::NoAction, {start}};
+  std::set<int> seen = {start};
+  int cell = start;
+  while (true) {
+    if (model.isTerminal(cell)) {
+      path.end = PathEnd::Terminal;
+      return path;
+    }
+    const auto xy = model.cellCoordinates(cell);
+    int x = xy.first;
+    int y = xy.second;
+    switch (policy[cell]) {
+    case '<': --x; break;
+    case '>': ++x; break;
+    case '^': ++y; break;
+    case 'v': --y; break;
+    default: return path;
+    }
+    int target = cell;
+    if (x >= 1 && x <= model.getWidth() && y >= 1 && y <= model.getHeight() &&
+        model.getType(model.cellIndex(x, y)) != 'F') {
+      target = model.cellIndex(x, y);
+    }
+    if (!seen.insert(target).second) {
+      path.end = PathEnd::Cycle;
+      return path;
+    }
+    path.cells.push_back(target);
+    cell = target;
+  }
+}
+
+void checkPath(PathQuery &paths, const TransitionModel &model,
+               const std::vector<char> &policy, int start) {
+  const Path expected = walk(model, policy, start);
+  const Path actual = paths.query(start);
+  CHECK(actual.end == expected.end);
+  CHECK(actual.cells == expected.cells);
+  CHECK_EQUAL(paths.getLength(start), int(expected.cells.size()) - 1);
+}
+
+} // namespace
+
+int main() {
+  // 4x1 row with the terminal at the right end.
+  const World row = loadWorld("W 4 1\nS 1 1\nR -0.04\nP 1 0 0\nT 4 1 1\n");
+  const TransitionModel rowModel(row);
+
+  {
+    // Two cells pointing at each other.
+    const std::vector<char> policy = {'>', '<', '<', ' '};
+    PathQuery paths(rowModel, policy);
+    const Path path = paths.query(0);
+    CHECK(path.end == PathEnd::Cycle);
+    CHECK((path.cells == std::vector<int>{0, 1}));
+    CHECK(paths.getEnd(1) == PathEnd::Cycle);
+    CHECK_EQUAL(paths.getLength(1), 1);
+    // Leads into the cycle from outside it.
+    CHECK((paths.query(2).cells == std::vector<int>{2, 1, 0}));
+    CHECK(paths.getEnd(2) == PathEnd::Cycle);
+  }
+  {
+    // A move into the wall stays in place, a cycle of one cell.
+    const std::vector<char> policy = {'<', '>', '>', ' '};
+    PathQuery paths(rowModel, policy);
+    CHECK(paths.getEnd(0) == PathEnd::Cycle);
+    CHECK_EQUAL(paths.getLength(0), 0);
+    CHECK(paths.getEnd(1) == PathEnd::Terminal);
+    CHECK((paths.query(1).cells == std::vector<int>{1, 2, 3}));
+  }
+  {
+    const std::vector<char> policy = {'>', ' ', '>', ' '};
+    PathQuery paths(rowModel, policy);
+    CHECK(paths.getEnd(0) == PathEnd::NoAction);
+    CHECK((paths.query(0).cells == std::vector<int>{0, 1}));
+    CHECK(paths.getEnd(3) == PathEnd::Terminal);
+    CHECK_EQUAL(paths.getLength(3), 0);
+  }
+
+  // Random policies, queried in random order so the memo is filled from
+  // every side, against the plain walk.
+  const World grid = loadWorld(
+      "W 12 9\nS 1 1\nR -0.04\nP 1 0 0\nT 12 9 1\nT 6 5 -1\nF 3 3\nF 8 2\n");
+  const TransitionModel model(grid);
+  const char symbols[] = {'<', '>', '^', 'v', '<', '>', '^', 'v', ' '};
+  std::mt19937 rng(7);
+  for (int round = 0; round < 200; ++round) {
+    std::vector<char> policy(model.size());
+    for (char &symbol : policy) {
+      symbol = symbols[rng() % 9];
+    }
+    std::vector<int> order(model.size());
+    for (int cell = 0; cell < model.size(); ++cell) {
+      order[cell] = cell;
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+    PathQuery paths(model, policy);
+    for (int start : order) {
+      checkPath(paths, model, policy, start);
+    }
+  }
+
+  bool thrown = false;
+  try {
+    PathQuery paths(rowModel, std::vector<char>(4, '>'));
+    paths.query(4);
+  } catch (const std::out_of_range &) {
+    thrown = true;
+  }
+  CHECK(thrown);
+  return checkFailures();
+}
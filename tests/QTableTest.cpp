@@ -0,0 +1,124 @@
+#include "Check.hpp"
+#include "QTable.hpp"
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Random writes and reads against std::map, with values every T stores
+// exactly.
+template <class T> void checkAgainstMap(size_t maxBytes, int cells) {
+  SparseQTable<T> table(4, maxBytes);
+  std::map<std::pair<int, int>, float> q;
+  std::map<std::pair<int, int>, uint32_t> visits;
+  std::mt19937 rng(3);
+  size_t capacity = 0;
+  size_t bytes = 0;
+  for (int i = 0; i < 200000; ++i) {
+    const int cell = rng() % cells;
+    const int action = rng() % 4;
+    if (rng() % 2) {
+      const float value = float(int(rng() % 512) - 256) / 8.0f;
+      table.setQ(cell, action, value);
+      q[std::make_pair(cell, action)] = value;
+    } else {
+      table.addVisit(cell, action);
+      ++visits[std::make_pair(cell, action)];
+    }
+
+    const int other = rng() % (cells + cells / 4);
+    const int otherAction = rng() % 4;
+    const auto key = std::make_pair(other, otherAction);
+    CHECK_EQUAL(table.getQ(other, otherAction), q.count(key) ? q[key] : 0.0f);
+    CHECK_EQUAL(table.getVisits(other, otherAction),
+                visits.count(key) ? visits[key] : 0u);
+
+    // Grows only by doubling, once more than half full.
+    if (table.getMemoryUsage() != bytes) {
+      QTableStats stats;
+      CHECK(table.getStats(stats));
+      CHECK(capacity == 0 || stats.capacity == 2 * capacity);
+      CHECK(capacity == 0 || stats.states * 2 > capacity);
+      CHECK(stats.bytes <= maxBytes);
+      capacity = stats.capacity;
+      bytes = stats.bytes;
+    }
+  }
+  CHECK(capacity > 1024); // grew at least once
+}
+
+} // namespace
+
+int main() {
+  checkAgainstMap<float>(size_t(4) << 20, 20000);
+  checkAgainstMap<Half>(size_t(4) << 20, 20000);
+  checkAgainstMap<BFloat16>(size_t(4) << 20, 20000);
+
+  {
+    // Stats of a table that grew freely: at most half full, short probes.
+    SparseQTable<float> table(4, size_t(64) << 20);
+    for (int cell = 0; cell < 100000; ++cell) {
+      table.addVisit(cell * 7, 0);
+    }
+    QTableStats stats;
+    CHECK(table.getStats(stats));
+    CHECK_EQUAL(stats.states, size_t(100000));
+    CHECK(stats.occupancy <= 0.5);
+    CHECK(stats.averageProbe < 1.0);
+    CHECK_EQUAL(stats.bytes, table.getMemoryUsage());
+  }
+
+  {
+    // Past the cap the table fills to 3/4 and then throws. The old and the
+    // doubled arrays of the last rehash fitted in the cap together.
+    const size_t maxBytes = 100000;
+    const size_t slotBytes = sizeof(int32_t) + 4 * (sizeof(float) + 4);
+    SparseQTable<float> table(4, maxBytes);
+    bool thrown = false;
+    int cell = 0;
+    try {
+      for (; cell < 100000; ++cell) {
+        table.addVisit(cell, 0);
+      }
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    CHECK(thrown);
+    QTableStats stats;
+    table.getStats(stats);
+    CHECK_EQUAL(stats.states, stats.capacity * 3 / 4);
+    CHECK_EQUAL(size_t(cell), stats.states);
+    CHECK(stats.capacity / 2 * slotBytes + stats.capacity * slotBytes <=
+          maxBytes);
+    CHECK(stats.capacity * slotBytes + 2 * stats.capacity * slotBytes >
+          maxBytes);
+    // Stored entries survive the failed insert.
+    CHECK_EQUAL(table.getVisits(0, 0), 1u);
+    CHECK_EQUAL(table.getVisits(cell - 1, 0), 1u);
+  }
+
+  {
+    bool thrown = false;
+    try {
+      SparseQTable<float> table(4, 100);
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+    CHECK(thrown);
+  }
+
+  {
+    DenseQTable<Half> table(10, 4);
+    table.setQ(9, 3, 0.5f);
+    table.addVisit(9, 3);
+    CHECK_EQUAL(table.getQ(9, 3), 0.5f);
+    CHECK_EQUAL(table.getVisits(9, 3), 1u);
+    CHECK_EQUAL(table.getQ(0, 0), 0.0f);
+    CHECK_EQUAL(table.getMemoryUsage(), size_t(10 * 4 * (2 + 4)));
+    QTableStats stats;
+    CHECK(!table.getStats(stats));
+  }
+  return checkFailures();
+}
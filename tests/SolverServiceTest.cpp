@@ -0,0 +1,115 @@
+#include "Check.hpp"
+#include "SolverService.hpp"
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+struct SocketPair {
+  int fds[2];
+  SocketPair() { CHECK(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0); }
+  ~SocketPair() {
+    closeWriter();
+    ::close(fds[1]);
+  }
+  void closeWriter() {
+    if (fds[0] >= 0) {
+      ::close(fds[0]);
+      fds[0] = -1;
+    }
+  }
+};
+
+// Writes on a second thread, so payloads larger than the socket buffer
+// do not block.
+std::string roundTrip(const std::string &payload) {
+  SocketPair pair;
+  bool written = false;
+  std::thread writer(
+      [&] { written = SolverService::writeFrame(pair.fds[0], payload); });
+  std::string read;
+  const bool ok = SolverService::readFrame(pair.fds[1], read);
+  writer.join();
+  CHECK(ok);
+  CHECK(written);
+  return read;
+}
+
+// With `endStream` unset the writer stays open, so only a frame rejected
+// from its header returns.
+bool readRaw(const std::string &bytes, bool endStream = true) {
+  SocketPair pair;
+  CHECK(::write(pair.fds[0], bytes.data(), bytes.size()) ==
+        ssize_t(bytes.size()));
+  if (endStream) {
+    pair.closeWriter();
+  }
+  std::string payload;
+  return SolverService::readFrame(pair.fds[1], payload);
+}
+
+} // namespace
+
+int main() {
+  CHECK_EQUAL(roundTrip(""), "");
+  CHECK_EQUAL(roundTrip("SHUTDOWN"), "SHUTDOWN");
+  const std::string binary("a\0b\n\xff\x80", 6);
+  CHECK(roundTrip(binary) == binary);
+  std::string large(3 << 20, 'x');
+  for (size_t i = 0; i < large.size(); i += 4099) {
+    large[i] = char(i);
+  }
+  CHECK(roundTrip(large) == large);
+
+  {
+    // Big endian length, then the payload.
+    SocketPair pair;
+    CHECK(SolverService::writeFrame(pair.fds[0], std::string(258, 'y')));
+    unsigned char header[4];
+    CHECK(::read(pair.fds[1], header, 4) == 4);
+    CHECK(header[0] == 0 && header[1] == 0 && header[2] == 1 &&
+          header[3] == 2);
+  }
+
+  CHECK(!readRaw(""));                           // end of stream
+  CHECK(!readRaw(std::string("\0\0", 2)));       // truncated header
+  CHECK(!readRaw(std::string("\0\0\0\5abc", 7))); // truncated payload
+  CHECK(readRaw(std::string("\0\0\0\3abc", 7)));
+  // One byte over kMaxFrameSize.
+  CHECK(!readRaw(std::string("\x04\0\0\x01abc", 7), false));
+
+  // Requests from untrusted payloads are answered, never crash.
+  SolverService service;
+  const char *bad[] = {"SOLVE\nW 3 3\nS 9 9\nR -1\nP 1 0 0\nT 3 3 1\n",
+                       "SOLVE\nW 0 3\nR -1\nP 1 0 0\nT 1 1 1\n",
+                       "SOLVE\nW 3 3\nR -1\nP 1 0 0\nT 4 3 1\n",
+                       "SOLVE\nW 3 3\nR -1\nP 1 0 0\nT 3 3 1\nF 0 1\n",
+                       "SOLVE\nW 100000 100000\nR -1\nP 1 0 0\nT 1 1 1\n",
+                       "RESOLVE zz\nF 1 1\n",
+                       "POLICY 0 1 1",
+                       "NOPE"};
+  for (const char *request : bad) {
+    CHECK_EQUAL(service.handle(request).substr(0, 4), "ERR ");
+  }
+
+  const std::string world = "W 4 3\nS 1 1\nP 0.8 0.1 0.1\nR -0.04\nG 1.0\n"
+                            "T 4 2 -1\nT 4 3 1\nF 2 2\n";
+  const std::string solved = service.handle("SOLVE\n" + world);
+  CHECK_EQUAL(solved.substr(0, 3), "OK ");
+  const std::string hash = solved.substr(3, solved.find(' ', 3) - 3);
+  CHECK_EQUAL(service.handle("POLICY " + hash + " 1 1").substr(0, 5), "OK ^ ");
+  // Removing the F line and adding it back gives the same world.
+  const std::string removed =
+      service.handle("RESOLVE " + hash + "\n-F 2 2\n");
+  const std::string removedHash =
+      removed.substr(3, removed.find(' ', 3) - 3);
+  CHECK(removedHash != hash);
+  const std::string restored =
+      service.handle("RESOLVE " + removedHash + "\nF 2 2\n");
+  CHECK_EQUAL(restored.substr(3, restored.find(' ', 3) - 3), hash);
+  CHECK_EQUAL(service.handle("RESOLVE " + hash + "\n-F 3 3\n").substr(0, 4),
+              "ERR ");
+  return checkFailures();
+}